@@ -1,36 +1,84 @@
 #pragma once
-#include <mutex>
-#include <string>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
 
-// Simple data structure to hold the snapshot of the engine
-struct ECUData {
+// Simple data structure to hold the snapshot of the engine.
+// Fixed size and exactly one cache line: no std::string, so copying it never allocates.
+struct alignas(64) ECUData {
     int rpm = 0;
     float throttle = 0.0f;
     float coolant = 0.0f;
     float load = 0.0f;
     float injectionMs = 0.0f;
-    std::string activeDTC = "None";
+    char activeDTC[8] = "None";     // "P0217" etc.
+
+    bool hasDTC() const { return std::strcmp(activeDTC, "None") != 0; }
 };
 
-// Thread-safe container
+static_assert(sizeof(ECUData) == 64, "ECUData should stay one cache line");
+static_assert(std::is_trivially_copyable<ECUData>::value, "ECUData is copied word by word");
+
+// Lock-free snapshot container (seqlock).
+// One writer (the ECU control task) publishes; any number of readers (GUI,
+// telemetry) take consistent copies. The writer never waits for a reader;
+// a reader that overlaps an update simply retries.
 class ECUState {
 public:
-    void update(int rpm, float throttle, float coolant, float load, float inj, std::string dtc) {
-        std::lock_guard<std::mutex> lock(m);
+    // Start out holding a default snapshot ("None", zeros)
+    ECUState() { update(0, 0.0f, 0.0f, 0.0f, 0.0f, "None"); }
+
+    void update(int rpm, float throttle, float coolant, float load, float inj, const char* dtc) {
+        ECUData data;
         data.rpm = rpm;
         data.throttle = throttle;
         data.coolant = coolant;
         data.load = load;
         data.injectionMs = inj;
-        data.activeDTC = dtc;
+        std::strncpy(data.activeDTC, dtc, sizeof(data.activeDTC) - 1);
+        data.activeDTC[sizeof(data.activeDTC) - 1] = '\0';
+
+        std::array<uint64_t, Words> raw;
+        std::memcpy(raw.data(), &data, sizeof(data));
+
+        // Odd sequence = update in progress
+        uint64_t seq = sequence.load(std::memory_order_relaxed);
+        sequence.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        for (size_t i = 0; i < Words; i++) {
+            words[i].store(raw[i], std::memory_order_relaxed);
+        }
+
+        sequence.store(seq + 2, std::memory_order_release);
     }
 
-    ECUData read() {
-        std::lock_guard<std::mutex> lock(m);
+    ECUData read() const {
+        std::array<uint64_t, Words> raw;
+        uint64_t before, after;
+
+        do {
+            before = sequence.load(std::memory_order_acquire);
+            for (size_t i = 0; i < Words; i++) {
+                raw[i] = words[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            after = sequence.load(std::memory_order_relaxed);
+        } while ((before & 1) || before != after);
+
+        ECUData data;
+        std::memcpy(static_cast<void*>(&data), raw.data(), sizeof(data));
         return data;
     }
 
+    // Bumps by 2 on every update; lets a reader tell whether anything changed
+    uint64_t getVersion() const { return sequence.load(std::memory_order_acquire); }
+
 private:
-    ECUData data;
-    std::mutex m;
-};
\ No newline at end of file
+    static constexpr size_t Words = sizeof(ECUData) / sizeof(uint64_t);
+
+    alignas(64) std::atomic<uint64_t> sequence{0};
+    alignas(64) std::array<std::atomic<uint64_t>, Words> words;
+};
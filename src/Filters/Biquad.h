@@ -0,0 +1,154 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include "FilterDesign.h"
+#include "../common/Span.h"
+
+// Second-order IIR section, transposed direct form II (two state values, good
+// behaviour in single precision). Coefficients come from FilterDesign and can
+// be constexpr:
+//
+//   Biquad mapFilter{FilterDesign::lowPass(50.0, 1000.0)};
+//
+// Every filter in this directory has the same two entry points:
+//   float process(float x)                         one sample
+//   void process(Span<const float>, Span<float>)   a block; in and out may be
+//                                                  the same buffer
+// A recursive filter is sequential in time, so the block path cannot be
+// vectorized along the block; what it buys is the state held in registers
+// across the loop instead of reloaded per call. To vectorize, filter across
+// channels instead: BiquadBank runs one sample of many channels per call.
+class Biquad {
+public:
+    constexpr Biquad() = default;
+    constexpr explicit Biquad(const BiquadCoeffs& coeffs) : c(coeffs) {}
+
+    float process(float x) {
+        float y = c.b0 * x + z1;
+        z1 = c.b1 * x - c.a1 * y + z2;
+        z2 = c.b2 * x - c.a2 * y;
+        return y;
+    }
+
+    void process(Span<const float> in, Span<float> out) {
+        const BiquadCoeffs k = c;
+        float s1 = z1, s2 = z2;
+        for (size_t i = 0; i < in.size(); i++) {
+            float x = in[i];
+            float y = k.b0 * x + s1;
+            s1 = k.b1 * x - k.a1 * y + s2;
+            s2 = k.b2 * x - k.a2 * y;
+            out[i] = y;
+        }
+        z1 = s1;
+        z2 = s2;
+    }
+
+    // Start from the steady state for a constant input, so the first output
+    // equals `value` instead of ringing up from zero
+    void reset(float value = 0.0f) {
+        float y = static_cast<float>(value * FilterDesign::dcGain(c));
+        z2 = c.b2 * value - c.a2 * y;
+        z1 = y - c.b0 * value;
+    }
+
+    void setCoefficients(const BiquadCoeffs& coeffs) { c = coeffs; }
+    const BiquadCoeffs& getCoefficients() const { return c; }
+
+private:
+    BiquadCoeffs c;
+    float z1 = 0.0f;
+    float z2 = 0.0f;
+};
+
+// Higher-order IIR as Stages second-order sections in series. The block path
+// runs each section over the whole block before the next, keeping every loop
+// short and its state in registers.
+template <size_t Stages>
+class BiquadCascade {
+    static_assert(Stages >= 1, "A cascade needs at least one section");
+
+public:
+    constexpr BiquadCascade() = default;
+    constexpr explicit BiquadCascade(const std::array<BiquadCoeffs, Stages>& coeffs) {
+        for (size_t s = 0; s < Stages; s++) sections[s] = Biquad(coeffs[s]);
+    }
+
+    float process(float x) {
+        for (auto& s : sections) x = s.process(x);
+        return x;
+    }
+
+    void process(Span<const float> in, Span<float> out) {
+        sections[0].process(in, out);
+        for (size_t s = 1; s < Stages; s++) sections[s].process(out, out);
+    }
+
+    void reset(float value = 0.0f) {
+        for (auto& s : sections) {
+            s.reset(value);
+            value = static_cast<float>(value * FilterDesign::dcGain(s.getCoefficients()));
+        }
+    }
+
+    Biquad& section(size_t i) { return sections[i]; }
+
+private:
+    std::array<Biquad, Stages> sections{};
+};
+
+// The same second-order section applied to Channels independent signals,
+// state kept structure-of-arrays. One call filters one sample of every
+// channel; the channel loop has no dependencies between iterations and
+// vectorizes. This is the path for conditioning hundreds of sensor channels
+// at a fixed rate. Coefficients are per channel (defaulting to one shared
+// design), so mixed cutoffs cost nothing extra.
+template <size_t Channels>
+class BiquadBank {
+public:
+    BiquadBank() = default;
+    explicit BiquadBank(const BiquadCoeffs& coeffs) { setCoefficients(coeffs); }
+
+    static constexpr size_t size() { return Channels; }
+
+    void setCoefficients(const BiquadCoeffs& coeffs) {
+        for (size_t ch = 0; ch < Channels; ch++) setCoefficients(ch, coeffs);
+    }
+
+    void setCoefficients(size_t channel, const BiquadCoeffs& coeffs) {
+        b0[channel] = coeffs.b0;
+        b1[channel] = coeffs.b1;
+        b2[channel] = coeffs.b2;
+        a1[channel] = coeffs.a1;
+        a2[channel] = coeffs.a2;
+    }
+
+    // One frame: in[ch] is the new sample of channel ch (in and out may alias)
+    void process(Span<const float> in, Span<float> out) {
+        const float* x = in.data();
+        float* y = out.data();
+        for (size_t ch = 0; ch < Channels; ch++) {
+            float xi = x[ch];
+            float yi = b0[ch] * xi + z1[ch];
+            z1[ch] = b1[ch] * xi - a1[ch] * yi + z2[ch];
+            z2[ch] = b2[ch] * xi - a2[ch] * yi;
+            y[ch] = yi;
+        }
+    }
+
+    // `frames` consecutive frames, interleaved (frame f, channel ch at f * Channels + ch)
+    void process(Span<const float> in, Span<float> out, size_t frames) {
+        for (size_t f = 0; f < frames; f++) {
+            process(in.subspan(f * Channels, Channels), out.subspan(f * Channels, Channels));
+        }
+    }
+
+    void reset() {
+        z1.fill(0.0f);
+        z2.fill(0.0f);
+    }
+
+private:
+    alignas(32) std::array<float, Channels> b0{}, b1{}, b2{}, a1{}, a2{};
+    alignas(32) std::array<float, Channels> z1{}, z2{};
+};
@@ -0,0 +1,41 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include "../common/Span.h"
+
+// Debounce for a boolean condition (a switch input, "coolant above limit"):
+// the output only changes once the input has disagreed with it for
+// `setSamples` consecutive samples going true, or `clearSamples` going false.
+// Fault monitors use it so that one noisy reading does not set a DTC.
+class Debounce {
+public:
+    constexpr Debounce(uint16_t setSamples, uint16_t clearSamples, bool initial = false)
+        : setCount(setSamples), clearCount(clearSamples), state(initial) {}
+
+    bool process(bool x) {
+        if (x == state) {
+            count = 0;
+        } else if (++count >= (x ? setCount : clearCount)) {
+            state = x;
+            count = 0;
+        }
+        return state;
+    }
+
+    void process(Span<const uint8_t> in, Span<uint8_t> out) {
+        for (size_t i = 0; i < in.size(); i++) out[i] = process(in[i] != 0);
+    }
+
+    bool get() const { return state; }
+
+    void reset(bool value = false) {
+        state = value;
+        count = 0;
+    }
+
+private:
+    uint16_t setCount;
+    uint16_t clearCount;
+    uint16_t count = 0;
+    bool state;
+};
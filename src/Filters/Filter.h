@@ -1,9 +1,11 @@
 #pragma once
+#include <cstddef>
+#include "../common/Span.h"
 
 class LowPassFilter {
 public:
-    LowPassFilter(float alpha = 0.1f)
-        : alpha(alpha), initialized(false), lastValue(0.0f) {}
+    constexpr LowPassFilter(float alpha = 0.1f)
+        : alpha(alpha), lastValue(0.0f), initialized(false) {}
 
     float apply(float input) {
         if (!initialized) {
@@ -16,10 +18,39 @@ public:
         return lastValue;
     }
 
+    float process(float input) { return apply(input); }
+
+    // Block path: the first-sample check is made once, outside the loop
+    void process(Span<const float> in, Span<float> out) {
+        if (in.empty()) return;
+        size_t i = 0;
+        if (!initialized) {
+            initialized = true;
+            lastValue = in[0];
+            out[0] = in[0];
+            i = 1;
+        }
+
+        float y = lastValue;
+        for (; i < in.size(); i++) {
+            y = y + alpha * (in[i] - y);
+            out[i] = y;
+        }
+        lastValue = y;
+    }
+
+    void reset(float value) {
+        lastValue = value;
+        initialized = true;
+    }
+
 private:
     float alpha;
     float lastValue;
     bool initialized;
 };
 // ✔ Simple low-pass filter class
-// ✔ Configurable smoothing factor (alpha)
\ No newline at end of file
+// ✔ Configurable smoothing factor (alpha)
+// ✔ Block processing (process(in, out)); the rest of the toolkit follows the
+//   same interface: Biquad.h, MovingAverage.h, MedianFilter.h, RateLimiter.h,
+//   Debounce.h, composed with FilterChain.h, coefficients from FilterDesign.h
\ No newline at end of file
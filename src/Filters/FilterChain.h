@@ -0,0 +1,47 @@
+#pragma once
+#include <cstddef>
+#include <tuple>
+#include <utility>
+#include "../common/Span.h"
+
+// Filters composed in series at compile time. The stages live by value in a
+// tuple, so a chain is one flat object with no virtual calls, and each stage
+// is inlined where it is used:
+//
+//   FilterChain conditioning{ MedianFilter<3>{}, Biquad{FilterDesign::lowPass(20.0, 1000.0)} };
+//   conditioning.process(raw, filtered);
+//
+// The block path runs the whole block through one stage before the next
+// (the first stage writes `out`, the rest work in place), so each stage's
+// loop stays tight with its state in registers.
+template <typename... Filters>
+class FilterChain {
+    static_assert(sizeof...(Filters) >= 1, "A chain needs at least one filter");
+
+public:
+    constexpr FilterChain() = default;
+    constexpr explicit FilterChain(Filters... filters) : stages(std::move(filters)...) {}
+
+    float process(float x) {
+        std::apply([&x](auto&... stage) { ((x = stage.process(x)), ...); }, stages);
+        return x;
+    }
+
+    void process(Span<const float> in, Span<float> out) {
+        std::get<0>(stages).process(in, out);
+        processInPlace(out, std::make_index_sequence<sizeof...(Filters) - 1>{});
+    }
+
+    template <size_t I>
+    auto& stage() { return std::get<I>(stages); }
+
+    static constexpr size_t size() { return sizeof...(Filters); }
+
+private:
+    template <size_t... I>
+    void processInPlace(Span<float> buffer, std::index_sequence<I...>) {
+        (std::get<I + 1>(stages).process(buffer, buffer), ...);
+    }
+
+    std::tuple<Filters...> stages;
+};
@@ -0,0 +1,118 @@
+#pragma once
+#include <array>
+#include <cstddef>
+
+// Filter coefficients computed at compile time from a cutoff and a sample
+// rate, e.g.
+//
+//   constexpr BiquadCoeffs ThrottleLP = FilterDesign::lowPass(25.0f, 1000.0f);
+//
+// <cmath> is not constexpr before C++26, so the few functions needed here
+// (sin, cos, tan) are evaluated by series in double precision. They are
+// only meant for design-time arguments (angles within a quarter turn), not as
+// general replacements.
+
+// Normalized (a0 = 1) second-order section:
+//   y[n] = b0 x[n] + b1 x[n-1] + b2 x[n-2] - a1 y[n-1] - a2 y[n-2]
+struct BiquadCoeffs {
+    float b0 = 1.0f, b1 = 0.0f, b2 = 0.0f;
+    float a1 = 0.0f, a2 = 0.0f;
+};
+
+namespace FilterDesign {
+
+constexpr double Pi = 3.14159265358979323846;
+constexpr double Butterworth = 0.70710678118654752440; // Q of a 2nd-order Butterworth section
+
+constexpr double sin(double x) {
+    double term = x, sum = x;
+    for (int n = 1; n < 14; n++) {
+        term *= -x * x / ((2 * n) * (2 * n + 1));
+        sum += term;
+    }
+    return sum;
+}
+
+constexpr double cos(double x) {
+    double term = 1.0, sum = 1.0;
+    for (int n = 1; n < 14; n++) {
+        term *= -x * x / ((2 * n - 1) * (2 * n));
+        sum += term;
+    }
+    return sum;
+}
+
+constexpr double tan(double x) { return sin(x) / cos(x); }
+
+// Bilinear-transform prewarp, K = tan(pi * fc / fs). The cutoff is clamped
+// just below Nyquist, where the transform stops being defined.
+constexpr double prewarp(double cutoffHz, double sampleRateHz) {
+    double ratio = cutoffHz / sampleRateHz;
+    if (ratio < 1e-6) ratio = 1e-6;
+    if (ratio > 0.49) ratio = 0.49;
+    return tan(Pi * ratio);
+}
+
+// Smoothing factor for the single-pole LowPassFilter (exponential moving
+// average) with the given -3 dB cutoff
+constexpr float onePoleAlpha(double cutoffHz, double sampleRateHz) {
+    double w = 2.0 * Pi * cutoffHz / sampleRateHz;
+    return static_cast<float>(w / (1.0 + w));
+}
+
+constexpr BiquadCoeffs lowPass(double cutoffHz, double sampleRateHz, double q = Butterworth) {
+    double k = prewarp(cutoffHz, sampleRateHz);
+    double norm = 1.0 / (1.0 + k / q + k * k);
+    BiquadCoeffs c;
+    c.b0 = static_cast<float>(k * k * norm);
+    c.b1 = static_cast<float>(2.0 * k * k * norm);
+    c.b2 = c.b0;
+    c.a1 = static_cast<float>(2.0 * (k * k - 1.0) * norm);
+    c.a2 = static_cast<float>((1.0 - k / q + k * k) * norm);
+    return c;
+}
+
+constexpr BiquadCoeffs highPass(double cutoffHz, double sampleRateHz, double q = Butterworth) {
+    double k = prewarp(cutoffHz, sampleRateHz);
+    double norm = 1.0 / (1.0 + k / q + k * k);
+    BiquadCoeffs c;
+    c.b0 = static_cast<float>(norm);
+    c.b1 = static_cast<float>(-2.0 * norm);
+    c.b2 = c.b0;
+    c.a1 = static_cast<float>(2.0 * (k * k - 1.0) * norm);
+    c.a2 = static_cast<float>((1.0 - k / q + k * k) * norm);
+    return c;
+}
+
+// Rejects a narrow band around centerHz (e.g. injector or ignition ripple)
+constexpr BiquadCoeffs notch(double centerHz, double sampleRateHz, double q = 10.0) {
+    double k = prewarp(centerHz, sampleRateHz);
+    double norm = 1.0 / (1.0 + k / q + k * k);
+    BiquadCoeffs c;
+    c.b0 = static_cast<float>((1.0 + k * k) * norm);
+    c.b1 = static_cast<float>(2.0 * (k * k - 1.0) * norm);
+    c.b2 = c.b0;
+    c.a1 = c.b1;
+    c.a2 = static_cast<float>((1.0 - k / q + k * k) * norm);
+    return c;
+}
+
+// Butterworth low-pass of order 2 * Stages as a cascade of second-order
+// sections (for BiquadCascade<Stages>). Pole pair k sits at angle
+// (2k + 1) * pi / (2 * order) from the imaginary axis, so its Q is 1 / (2 sin angle).
+template <size_t Stages>
+constexpr std::array<BiquadCoeffs, Stages> butterworthLowPass(double cutoffHz, double sampleRateHz) {
+    std::array<BiquadCoeffs, Stages> sections{};
+    for (size_t k = 0; k < Stages; k++) {
+        double angle = (2.0 * k + 1.0) * Pi / (4.0 * Stages);
+        sections[k] = lowPass(cutoffHz, sampleRateHz, 1.0 / (2.0 * sin(angle)));
+    }
+    return sections;
+}
+
+// Steady-state gain of a section for a constant input (1 for low-pass)
+constexpr double dcGain(const BiquadCoeffs& c) {
+    return (static_cast<double>(c.b0) + c.b1 + c.b2) / (1.0 + c.a1 + c.a2);
+}
+
+} // namespace FilterDesign
@@ -0,0 +1,106 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include "../common/Span.h"
+
+// Median of the last N samples (N odd). Removes single-sample spikes (an
+// ignition pulse on a sensor line, a dropped ADC read) without smearing
+// steps the way an average does.
+//
+// The window is kept twice: in arrival order, to know which sample leaves,
+// and sorted. Each new sample replaces the leaving one in the sorted copy and
+// is moved into place by insertion, O(N) with short branch-predictable loops
+// for the small N used on sensors (3..15).
+template <size_t N>
+class MedianFilter {
+    static_assert(N % 2 == 1, "Median window must be odd");
+
+public:
+    constexpr MedianFilter() = default;
+
+    float process(float x) {
+        if (!primed) reset(x);
+
+        float leaving = history[pos];
+        history[pos] = x;
+        if (++pos == N) pos = 0;
+
+        // Find the leaving sample in the sorted copy and slide the new one
+        // from there to its place
+        size_t i = 0;
+        while (i + 1 < N && sorted[i] != leaving) i++;
+        while (i > 0 && sorted[i - 1] > x) {
+            sorted[i] = sorted[i - 1];
+            i--;
+        }
+        while (i + 1 < N && sorted[i + 1] < x) {
+            sorted[i] = sorted[i + 1];
+            i++;
+        }
+        sorted[i] = x;
+        return sorted[N / 2];
+    }
+
+    void process(Span<const float> in, Span<float> out) {
+        for (size_t i = 0; i < in.size(); i++) out[i] = process(in[i]);
+    }
+
+    void reset(float value = 0.0f) {
+        history.fill(value);
+        sorted.fill(value);
+        pos = 0;
+        primed = true;
+    }
+
+private:
+    std::array<float, N> history{};
+    std::array<float, N> sorted{};
+    size_t pos = 0;
+    bool primed = false;
+};
+
+// Median of three, the common case, without any window bookkeeping
+template <>
+class MedianFilter<3> {
+public:
+    constexpr MedianFilter() = default;
+
+    float process(float x) {
+        if (!primed) reset(x);
+        float m = median(x1, x2, x);
+        x1 = x2;
+        x2 = x;
+        return m;
+    }
+
+    void process(Span<const float> in, Span<float> out) {
+        if (!primed && !in.empty()) reset(in[0]);
+        float a = x1, b = x2;
+        for (size_t i = 0; i < in.size(); i++) {
+            float x = in[i];
+            out[i] = median(a, b, x);
+            a = b;
+            b = x;
+        }
+        x1 = a;
+        x2 = b;
+    }
+
+    void reset(float value = 0.0f) {
+        x1 = x2 = value;
+        primed = true;
+    }
+
+private:
+    // min/max only, so it compiles to selects rather than branches
+    static float median(float a, float b, float c) {
+        float lo = a < b ? a : b;
+        float hi = a < b ? b : a;
+        float m = hi < c ? hi : c;
+        return lo > m ? lo : m;
+    }
+
+    float x1 = 0.0f;
+    float x2 = 0.0f;
+    bool primed = false;
+};
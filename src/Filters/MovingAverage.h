@@ -0,0 +1,66 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include "../common/Span.h"
+
+// Mean of the last N samples (boxcar FIR) in O(1) per sample: a running sum
+// plus the window to know what drops out. The float running sum would slowly
+// drift from rounding, so it is re-summed from the window once per wrap.
+// Until N samples have been seen the window is assumed filled with the first
+// one (see reset()).
+template <size_t N>
+class MovingAverage {
+    static_assert(N >= 1, "Window must hold at least one sample");
+
+public:
+    constexpr MovingAverage() = default;
+
+    float process(float x) {
+        if (!primed) reset(x);
+        sum += x - window[pos];
+        window[pos] = x;
+        if (++pos == N) wrap();
+        return sum * (1.0f / N);
+    }
+
+    void process(Span<const float> in, Span<float> out) {
+        size_t i = 0;
+        if (!primed && !in.empty()) reset(in[0]);
+        while (i < in.size()) {
+            // Run to the end of the window without the wrap check per sample
+            size_t run = N - pos;
+            if (run > in.size() - i) run = in.size() - i;
+            float s = sum;
+            for (size_t k = 0; k < run; k++) {
+                float x = in[i + k];
+                s += x - window[pos + k];
+                window[pos + k] = x;
+                out[i + k] = s * (1.0f / N);
+            }
+            sum = s;
+            pos += run;
+            i += run;
+            if (pos == N) wrap();
+        }
+    }
+
+    void reset(float value = 0.0f) {
+        window.fill(value);
+        sum = value * N;
+        pos = 0;
+        primed = true;
+    }
+
+private:
+    void wrap() {
+        pos = 0;
+        float s = 0.0f;
+        for (float v : window) s += v;
+        sum = s;
+    }
+
+    std::array<float, N> window{};
+    float sum = 0.0f;
+    size_t pos = 0;
+    bool primed = false;
+};
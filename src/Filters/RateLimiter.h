@@ -0,0 +1,48 @@
+#pragma once
+#include <cstddef>
+#include "../common/Span.h"
+
+// Limits how fast a signal may rise and fall, in units per second, e.g. a
+// throttle target that must not step faster than the actuator can follow.
+// The per-sample limits are fixed at construction from the sample rate.
+class RateLimiter {
+public:
+    constexpr RateLimiter(float risePerSecond, float fallPerSecond, float sampleRateHz)
+        : rise(risePerSecond / sampleRateHz), fall(fallPerSecond / sampleRateHz) {}
+
+    // Symmetric limit
+    constexpr RateLimiter(float ratePerSecond, float sampleRateHz)
+        : RateLimiter(ratePerSecond, ratePerSecond, sampleRateHz) {}
+
+    float process(float x) {
+        if (!primed) reset(x);
+        last += clampStep(x - last);
+        return last;
+    }
+
+    void process(Span<const float> in, Span<float> out) {
+        if (!primed && !in.empty()) reset(in[0]);
+        float y = last;
+        for (size_t i = 0; i < in.size(); i++) {
+            y += clampStep(in[i] - y);
+            out[i] = y;
+        }
+        last = y;
+    }
+
+    void reset(float value = 0.0f) {
+        last = value;
+        primed = true;
+    }
+
+private:
+    float clampStep(float delta) const {
+        delta = delta < rise ? delta : rise;
+        return delta > -fall ? delta : -fall;
+    }
+
+    float rise;
+    float fall;
+    float last = 0.0f;
+    bool primed = false;
+};
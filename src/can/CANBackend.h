@@ -0,0 +1,18 @@
+#pragma once
+#include <cstddef>
+#include "CANMessage.h"
+
+// Transport behind a CANBus. The in-memory bus needs none; a backend bridges
+// the simulated bus to something outside the process (e.g. a SocketCAN interface).
+class CANBackend {
+public:
+    virtual ~CANBackend() = default;
+
+    // Queue a frame for the wire. Called from sendMessage() on any thread, so it
+    // must be cheap and thread-safe; the actual I/O happens in poll().
+    virtual void transmit(const CANMessage& msg) = 0;
+
+    // Flush queued frames and collect up to maxCount received ones into out.
+    // Returns how many were received. Called from one thread only.
+    virtual size_t poll(CANMessage* out, size_t maxCount) = 0;
+};
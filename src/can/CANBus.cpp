@@ -1,20 +1,85 @@
 #include "CANBus.h"
+#include <iostream>
 
-// Thread-safe way to put a message on the "wire"
+CANBus::SubscriberId CANBus::subscribe(std::initializer_list<CANFilter> filters) {
+    std::lock_guard<std::mutex> lock(subscribeMutex);
+
+    size_t index = subscriberCount.load(std::memory_order_relaxed);
+    if (index >= MaxSubscribers) {
+        std::cerr << "[CANBus] Error: Too many subscribers (max " << MaxSubscribers << ")\n";
+        return InvalidSubscriber;
+    }
+    if (filters.size() > MaxFiltersPerSubscriber) {
+        std::cerr << "[CANBus] Error: Too many filters (max " << MaxFiltersPerSubscriber << ")\n";
+        return InvalidSubscriber;
+    }
+
+    auto sub = std::make_unique<Subscriber>();
+    for (const auto& f : filters) {
+        sub->filters[sub->filterCount++] = f;
+    }
+    subscribers[index] = std::move(sub);
+
+    // Senders only look at slots below subscriberCount, so publish it last
+    subscriberCount.store(index + 1, std::memory_order_release);
+    return index;
+}
+
+// Lock-free way to put a message on the "wire"
 void CANBus::sendMessage(const CANMessage& msg) {
-    std::lock_guard<std::mutex> lock(busMutex);
-    messages.push_back(msg);
+    if (msg.timestamp == std::chrono::steady_clock::time_point{}) {
+        CANMessage stamped = msg;
+        stamped.timestamp = clock();
+        deliver(stamped);
+        if (backend) backend->transmit(stamped);
+        return;
+    }
+
+    deliver(msg);
+    if (backend) backend->transmit(msg);
+}
+
+void CANBus::setBackend(std::unique_ptr<CANBackend> newBackend) {
+    backend = std::move(newBackend);
+}
+
+void CANBus::poll() {
+    if (!backend) return;
+
+    // Frames from outside only go to local nodes, never back to the backend
+    size_t count;
+    while ((count = backend->poll(pollBuffer.data(), pollBuffer.size())) > 0) {
+        for (size_t i = 0; i < count; i++) {
+            deliver(pollBuffer[i]);
+        }
+    }
+}
+
+void CANBus::deliver(const CANMessage& msg) {
+    size_t count = subscriberCount.load(std::memory_order_acquire);
+    for (size_t i = 0; i < count; i++) {
+        Subscriber& sub = *subscribers[i];
+        if (!sub.accepts(msg.id)) continue;
+
+        if (!sub.queue.tryPush(msg)) {
+            sub.overflowCount.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
+
+// Retrieve this node's messages into the caller's buffer (simulating that they were "received")
+size_t CANBus::readMessages(SubscriberId subscriber, CANMessage* out, size_t maxCount) {
+    if (subscriber >= subscriberCount.load(std::memory_order_acquire)) return 0;
+    return subscribers[subscriber]->queue.drain(out, maxCount);
 }
 
-// Retrieve all messages and clear the bus (simulating that they were "received")
-std::vector<CANMessage> CANBus::readMessages() {
-    std::lock_guard<std::mutex> lock(busMutex);
-    std::vector<CANMessage> currentMessages = messages;
-    messages.clear(); // Clear the bus after reading
-    return currentMessages;
+uint64_t CANBus::getOverflowCount(SubscriberId subscriber) const {
+    if (subscriber >= subscriberCount.load(std::memory_order_acquire)) return 0;
+    return subscribers[subscriber]->overflowCount.load(std::memory_order_relaxed);
 }
 // Simple in-memory CAN Bus Simulator
 // Multiple ECUs can send and receive CAN frames via this bus.
 // In a real system, CAN frames are broadcast to all nodes.
 
-// We used std::lock_guard. Since the Scheduler might run tasks on different threads (or if we add a GUI later), we don't want to read the vector while someone else is writing to it. This prevents a crash.
\ No newline at end of file
+// The per-node ring buffers are safe for several senders and a reader on
+// different scheduler bands at once, without a mutex on the send path.
@@ -1,34 +1,112 @@
 #pragma once
-#include <vector>
+#include <array>
+#include <chrono>
+#include <functional>
+#include <atomic>
+#include <memory>
 #include <mutex>
+#include <initializer_list>
+#include <cstddef>
+#include <cstdint>
 #include "CANMessage.h"
+#include "CANBackend.h"
+#include "../common/RingBuffer.h"
+
+// Hardware-style acceptance filter: a frame passes when the bits selected by
+// mask match. {0x200, 0x7FF} accepts exactly 0x200, {0x200, 0x700} accepts 0x200-0x2FF.
+struct CANFilter {
+    uint32_t id;
+    uint32_t mask;
+
+    bool matches(uint32_t frameId) const { return (frameId & mask) == (id & mask); }
+};
 
 class CANBus {
 public:
-    // Send a CAN frame onto the virtual bus
+    using SubscriberId = size_t;
+    static constexpr SubscriberId InvalidSubscriber = static_cast<SubscriberId>(-1);
+
+    static constexpr size_t MaxSubscribers = 16;
+    static constexpr size_t MaxFiltersPerSubscriber = 4;   // Like a controller's filter banks
+    static constexpr size_t QueueCapacity = 1024;          // Per-subscriber receive queue
+
+    // Attach a node to the bus. It receives every frame that passes any of its
+    // filters; no filters means it receives all traffic.
+    SubscriberId subscribe(std::initializer_list<CANFilter> filters = {});
+
+    // Broadcast a CAN frame to every subscriber whose filters accept it
+    // (lock-free, never allocates). Frames sent without a timestamp are
+    // stamped with the bus clock. A full receive queue drops the frame for
+    // that subscriber only, and counts it as an overflow.
     void sendMessage(const CANMessage& msg);
 
-    // Retrieve all messages currently on the bus
-    std::vector<CANMessage> readMessages();
+    // Move up to maxCount frames from this subscriber's queue into the caller's
+    // buffer. Returns how many were written.
+    size_t readMessages(SubscriberId subscriber, CANMessage* out, size_t maxCount);
+
+    // Frames this subscriber lost because its queue was full
+    uint64_t getOverflowCount(SubscriberId subscriber) const;
+
+    // Time source for stamping frames. Defaults to steady_clock; point it at the
+    // scheduler when running on virtual time. Set before traffic starts.
+    using Clock = std::function<std::chrono::steady_clock::time_point()>;
+    void setClock(Clock newClock) { clock = std::move(newClock); }
+
+    // Bridge the bus to an external transport. Set before traffic starts.
+    // Without a backend the bus is purely in-memory.
+    void setBackend(std::unique_ptr<CANBackend> newBackend);
+
+    // Flush outgoing frames to the backend and deliver everything it has
+    // received to the local subscribers. Call periodically from one task.
+    void poll();
 
 private:
-    std::vector<CANMessage> messages;
-    std::mutex busMutex;
+    static constexpr size_t PollBatch = 64;
+
+    // Fan a frame out to the local subscribers
+    void deliver(const CANMessage& msg);
+
+    struct Subscriber {
+        std::array<CANFilter, MaxFiltersPerSubscriber> filters;
+        size_t filterCount = 0;
+        RingBuffer<CANMessage, QueueCapacity> queue;
+        std::atomic<uint64_t> overflowCount{0};
+
+        bool accepts(uint32_t frameId) const {
+            if (filterCount == 0) return true;
+            for (size_t i = 0; i < filterCount; i++) {
+                if (filters[i].matches(frameId)) return true;
+            }
+            return false;
+        }
+    };
+
+    std::array<std::unique_ptr<Subscriber>, MaxSubscribers> subscribers;
+    std::atomic<size_t> subscriberCount{0};   // Published after the slot is filled
+    std::mutex subscribeMutex;                // Serialises subscribe() only
+
+    Clock clock = [] { return std::chrono::steady_clock::now(); };
+    std::unique_ptr<CANBackend> backend;
+    std::array<CANMessage, PollBatch> pollBuffer;
 };
 // Simple in-memory CAN Bus Simulator
 // Multiple ECUs can send and receive CAN frames via this bus.
-// In a real system, CAN frames are broadcast to all nodes.
-// Here, we just store them in a vector with thread safety.
+// In a real system, CAN frames are broadcast to all nodes, and each node's
+// controller filters them in hardware. We replicate that:
+// ✔ subscribe()
+
+// Registers a node with its acceptance filters and gives it its own queue.
+
 // ✔ sendMessage()
 
-// Adds a CAN frame into the message queue.
-// This simulates an ECU broadcasting a message.
+// Fans the frame out to every node whose filters match. Non-matching frames
+// are never copied into that node's queue.
 
 // ✔ readMessages()
 
-// Returns the messages currently on the bus.
-// We will use this later for debugging and for simulating multiple ECUs.
+// Drains one node's queue into a buffer the reader owns. Reading is not
+// destructive for other nodes: each sees its own copy of the traffic.
 
-// ✔ mutex
+// ✔ setBackend() / poll()
 
-// In real CAN, multiple ECUs write to the bus at the same time → here we replicate that safely
\ No newline at end of file
+// Optionally mirrors the bus onto real hardware or a vcan interface.
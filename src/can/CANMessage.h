@@ -1,11 +1,13 @@
 #pragma once
 #include <array>
 #include <chrono>
+#include <cstdint>
 
 struct CANMessage {
     unsigned int id;                     // Message ID (0x100, 0x200, etc)
     std::array<uint8_t, 8> data;         // 8-byte CAN payload
     std::chrono::steady_clock::time_point timestamp;
+    uint8_t dlc = 8;                     // Number of valid payload bytes (0-8)
 };
 // Basic CAN Message Structure
 // Every CAN frame has up to 8 bytes of data.
@@ -18,4 +20,4 @@ struct CANMessage {
 
 // 0x100 = RPM
 
-// 0x101 = Coolant
\ No newline at end of file
+// 0x101 = Coolant
@@ -0,0 +1,102 @@
+#pragma once
+#include <array>
+#include <ratio>
+#include <cstdint>
+
+// Compile-time CAN signal codec, modelled on DBC signal definitions:
+//
+//   SG_ <name> : <startBit>|<length>@<byteOrder><sign> (<factor>,<offset>)
+//
+// Every parameter is a template argument, so the shift, mask and scaling are
+// constants and each encode/decode compiles down to a load, a shift, a mask
+// and a multiply-add. There is no runtime signal table.
+
+enum class ByteOrder {
+    Intel,      // Little endian, DBC "@1". startBit is the signal's LSB.
+    Motorola    // Big endian,    DBC "@0". startBit is the signal's MSB (DBC sawtooth numbering).
+};
+
+using CANPayload = std::array<uint8_t, 8>;
+
+// The whole 8-byte payload as one integer, in the layout a byte order needs.
+// Load it once and decode many signals from it when unpacking a frame.
+template <ByteOrder Order>
+constexpr uint64_t loadPayload(const CANPayload& data) {
+    uint64_t word = 0;
+    for (unsigned i = 0; i < 8; i++) {
+        unsigned byteIndex = (Order == ByteOrder::Intel) ? i : 7 - i;
+        word |= static_cast<uint64_t>(data[byteIndex]) << (8 * i);
+    }
+    return word;
+}
+
+template <ByteOrder Order>
+constexpr void storePayload(CANPayload& data, uint64_t word) {
+    for (unsigned i = 0; i < 8; i++) {
+        unsigned byteIndex = (Order == ByteOrder::Intel) ? i : 7 - i;
+        data[byteIndex] = static_cast<uint8_t>(word >> (8 * i));
+    }
+}
+
+template <unsigned StartBit, unsigned Length, ByteOrder Order,
+          typename Factor = std::ratio<1>, typename Offset = std::ratio<0>, bool Signed = false>
+struct CANSignal {
+    static_assert(Length >= 1 && Length <= 32, "Signal length must be 1-32 bits");
+    static_assert(StartBit < 64, "Start bit must lie inside the 8-byte payload");
+
+    static constexpr ByteOrder order = Order;
+    static constexpr double factor = static_cast<double>(Factor::num) / Factor::den;
+    static constexpr double offset = static_cast<double>(Offset::num) / Offset::den;
+    static constexpr uint64_t mask = (uint64_t(1) << Length) - 1;
+
+    // Position of the signal's LSB inside the word from loadPayload<Order>()
+    static constexpr unsigned msbInWord = (7 - StartBit / 8) * 8 + StartBit % 8;
+    static_assert(Order == ByteOrder::Intel || msbInWord + 1 >= Length,
+                  "Motorola signal runs past the end of the payload");
+    static_assert(Order == ByteOrder::Motorola || StartBit + Length <= 64,
+                  "Intel signal runs past the end of the payload");
+    static constexpr unsigned shift = (Order == ByteOrder::Intel) ? StartBit : msbInWord + 1 - Length;
+
+    // Raw (unscaled) value from a preloaded payload word
+    static constexpr int64_t rawFromWord(uint64_t word) {
+        uint64_t raw = (word >> shift) & mask;
+        if (Signed && (raw & (uint64_t(1) << (Length - 1)))) {
+            return static_cast<int64_t>(raw | ~mask);   // Sign-extend
+        }
+        return static_cast<int64_t>(raw);
+    }
+
+    static constexpr uint64_t wordWithRaw(uint64_t word, int64_t raw) {
+        return (word & ~(mask << shift)) | ((static_cast<uint64_t>(raw) & mask) << shift);
+    }
+
+    // Physical value = raw * factor + offset
+    static constexpr double fromWord(uint64_t word) {
+        return static_cast<double>(rawFromWord(word)) * factor + offset;
+    }
+
+    static constexpr double decode(const CANPayload& data) {
+        return fromWord(loadPayload<Order>(data));
+    }
+
+    // Scales, rounds to nearest and saturates to the signal's raw range
+    static constexpr int64_t toRaw(double physical) {
+        double scaled = (physical - offset) / factor;
+        int64_t raw = static_cast<int64_t>(scaled < 0 ? scaled - 0.5 : scaled + 0.5);
+        return raw < minRaw ? minRaw : (raw > maxRaw ? maxRaw : raw);
+    }
+
+    static constexpr void encode(CANPayload& data, double physical) {
+        storePayload<Order>(data, wordWithRaw(loadPayload<Order>(data), toRaw(physical)));
+    }
+
+    static constexpr int64_t minRaw = Signed ? -static_cast<int64_t>(uint64_t(1) << (Length - 1)) : 0;
+    static constexpr int64_t maxRaw = Signed ? static_cast<int64_t>(mask >> 1) : static_cast<int64_t>(mask);
+};
+
+// A frame definition: DBC "BO_ <id> <name>: <dlc> <sender>"
+template <unsigned Id, uint8_t Dlc = 8>
+struct CANFrameDef {
+    static constexpr unsigned id = Id;
+    static constexpr uint8_t dlc = Dlc;
+};
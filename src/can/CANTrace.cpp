@@ -0,0 +1,117 @@
+#include "CANTrace.h"
+#include <iostream>
+#include <cstring>
+#include <algorithm>
+
+static const char TraceMagic[8] = { 'E', 'C', 'U', 'C', 'A', 'N', 'T', '\0' };
+static const uint32_t TraceVersion = 1;
+
+// --- Recorder ---
+
+CANTraceRecorder::CANTraceRecorder(CANBus& bus, const std::string& filename)
+    : bus(bus), subscriber(bus.subscribe()) {
+    pending.reserve(WriteBatch);
+
+    file.open(filename, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "[CANTrace] Error: Could not open file " << filename << "\n";
+        return;
+    }
+
+    CANTraceHeader header{};
+    std::memcpy(header.magic, TraceMagic, sizeof(TraceMagic));
+    header.version = TraceVersion;
+    header.recordSize = sizeof(CANTraceRecord);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+}
+
+CANTraceRecorder::~CANTraceRecorder() {
+    if (file.is_open()) {
+        poll();
+        writeBatch();
+        file.close();
+    }
+}
+
+void CANTraceRecorder::poll() {
+    if (!file.is_open()) return;
+
+    size_t count;
+    while ((count = bus.readMessages(subscriber, rxBuffer.data(), rxBuffer.size())) > 0) {
+        for (size_t i = 0; i < count; i++) {
+            const CANMessage& msg = rxBuffer[i];
+
+            // Trace time starts at the first frame
+            if (!started) {
+                startTime = msg.timestamp;
+                started = true;
+            }
+
+            CANTraceRecord rec{};
+            auto offset = std::chrono::duration_cast<std::chrono::nanoseconds>(msg.timestamp - startTime).count();
+            rec.timestampNs = offset > 0 ? static_cast<uint64_t>(offset) : 0;
+            rec.id = msg.id;
+            rec.dlc = msg.dlc;
+            std::memcpy(rec.data, msg.data.data(), sizeof(rec.data));
+            pending.push_back(rec);
+
+            if (pending.size() == WriteBatch) writeBatch();
+        }
+    }
+}
+
+void CANTraceRecorder::writeBatch() {
+    if (pending.empty()) return;
+    file.write(reinterpret_cast<const char*>(pending.data()),
+               static_cast<std::streamsize>(pending.size() * sizeof(CANTraceRecord)));
+    recordCount += pending.size();
+    pending.clear();
+}
+
+// --- Replayer ---
+
+CANTraceReplayer::CANTraceReplayer(CANBus& bus, const std::string& filename)
+    : bus(bus) {
+    if (!mapping.open(filename, MappedFile::Mode::ReadOnly)) return;
+
+    const auto* header = reinterpret_cast<const CANTraceHeader*>(mapping.data());
+    if (mapping.size() < sizeof(CANTraceHeader) ||
+        std::memcmp(header->magic, TraceMagic, sizeof(TraceMagic)) != 0 ||
+        header->version != TraceVersion ||
+        header->recordSize != sizeof(CANTraceRecord)) {
+        std::cerr << "[CANTrace] Error: " << filename << " is not a CAN trace\n";
+        mapping.close();
+        return;
+    }
+
+    // Records sit right after the header; a torn last record is ignored
+    records = reinterpret_cast<const CANTraceRecord*>(mapping.data() + sizeof(CANTraceHeader));
+    recordCount = (mapping.size() - sizeof(CANTraceHeader)) / sizeof(CANTraceRecord);
+    mapping.adviseSequential();
+}
+
+size_t CANTraceReplayer::pump(std::chrono::nanoseconds elapsed, size_t maxFrames) {
+    if (!records) return 0;
+
+    bool unthrottled = (speed <= 0.0);
+    uint64_t dueNs = static_cast<uint64_t>(std::max(0.0, static_cast<double>(elapsed.count()) * speed));
+
+    size_t sent = 0;
+    while (cursor < recordCount && sent < maxFrames) {
+        const CANTraceRecord& rec = records[cursor];
+        if (!unthrottled && rec.timestampNs > dueNs) break;
+
+        CANMessage msg{};
+        msg.id = rec.id;
+        msg.dlc = rec.dlc;
+        std::memcpy(msg.data.data(), rec.data, sizeof(rec.data));
+        bus.sendMessage(msg);   // The bus stamps it with the current time
+
+        cursor++;
+        sent++;
+    }
+
+    // Let the kernel page in what comes next while we wait
+    mapping.prefetch(sizeof(CANTraceHeader) + cursor * sizeof(CANTraceRecord), 1 << 20);
+    return sent;
+}
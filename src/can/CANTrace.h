@@ -0,0 +1,89 @@
+#pragma once
+#include <chrono>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include "CANBus.h"
+#include "../common/MappedFile.h"
+
+// Binary CAN trace: a 24-byte header followed by fixed 24-byte records, so a
+// trace can be memory-mapped and indexed directly with no parsing.
+struct CANTraceHeader {
+    char magic[8];              // "ECUCANT\0"
+    uint32_t version;
+    uint32_t recordSize;        // sizeof(CANTraceRecord)
+    uint64_t reserved;
+};
+
+struct CANTraceRecord {
+    uint64_t timestampNs;       // Time since the start of the recording
+    uint32_t id;
+    uint8_t dlc;
+    uint8_t reserved[3];
+    uint8_t data[8];
+};
+
+static_assert(sizeof(CANTraceHeader) == 24, "CANTraceHeader layout is part of the file format");
+static_assert(sizeof(CANTraceRecord) == 24, "CANTraceRecord layout is part of the file format");
+
+// Captures every frame crossing the bus (it subscribes with no filter) into a
+// binary trace. Frames are written in large batches from poll().
+class CANTraceRecorder {
+public:
+    static constexpr size_t WriteBatch = 4096;  // Records buffered per write
+
+    CANTraceRecorder(CANBus& bus, const std::string& filename);
+    ~CANTraceRecorder();
+
+    bool isOpen() const { return file.is_open(); }
+
+    // Drain the bus into the trace. Call often enough that the subscriber
+    // queue (CANBus::QueueCapacity frames) never fills.
+    void poll();
+
+    uint64_t getRecordCount() const { return recordCount; }
+    uint64_t getDroppedCount() const { return bus.getOverflowCount(subscriber); }
+
+private:
+    void writeBatch();
+
+    CANBus& bus;
+    CANBus::SubscriberId subscriber;
+    std::ofstream file;
+    std::vector<CANTraceRecord> pending;        // Reserved once, never grows past WriteBatch
+    std::array<CANMessage, 256> rxBuffer;
+    std::chrono::steady_clock::time_point startTime{};
+    bool started = false;
+    uint64_t recordCount = 0;
+};
+
+// Memory-maps a trace and puts its frames back on the bus, at the recorded
+// pace (1x), N times faster, or as fast as possible.
+class CANTraceReplayer {
+public:
+    CANTraceReplayer(CANBus& bus, const std::string& filename);
+
+    bool isOpen() const { return records != nullptr; }
+
+    // 1.0 = recorded pace, 10.0 = ten times faster, 0 = as fast as possible
+    void setSpeed(double newSpeed) { speed = newSpeed; }
+
+    // Send every frame that is due after `elapsed` of replay time (measured on
+    // the caller's clock, e.g. Scheduler::now()), at most maxFrames of them.
+    // Returns how many frames were sent.
+    size_t pump(std::chrono::nanoseconds elapsed, size_t maxFrames = SIZE_MAX);
+
+    bool finished() const { return cursor >= recordCount; }
+    size_t getFrameCount() const { return recordCount; }
+    size_t getPosition() const { return cursor; }
+
+private:
+    CANBus& bus;
+    MappedFile mapping;
+    const CANTraceRecord* records = nullptr;
+    size_t recordCount = 0;
+    size_t cursor = 0;
+    double speed = 1.0;
+};
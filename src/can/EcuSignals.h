@@ -0,0 +1,32 @@
+#pragma once
+#include "CANSignal.h"
+
+// Signal database for the simulated vehicle network.
+// This header is the DBC: each line mirrors the DBC entry it would have.
+
+namespace EcuSignals {
+
+// BO_ 256 EngineStatus: 8 ECU
+struct EngineStatus : CANFrameDef<0x100> {
+    // SG_ EngineSpeed : 7|16@0+ (1,0) [0|65535] "rpm"
+    using EngineSpeed = CANSignal<7, 16, ByteOrder::Motorola>;
+    // SG_ ThrottlePosition : 23|8@0+ (1,0) [0|100] "%"
+    using ThrottlePosition = CANSignal<23, 8, ByteOrder::Motorola>;
+    // SG_ CoolantTemp : 31|8@0+ (1,-40) [-40|215] "degC"
+    using CoolantTemp = CANSignal<31, 8, ByteOrder::Motorola, std::ratio<1>, std::ratio<-40>>;
+};
+
+// BO_ 512 TcuCommand: 8 TCU
+struct TcuCommand : CANFrameDef<0x200> {
+    // SG_ TorqueRequest : 7|8@0+ (1,0) [0|255] "Nm"
+    using TorqueRequest = CANSignal<7, 8, ByteOrder::Motorola>;
+    // SG_ Gear : 15|8@0+ (1,0) [0|8] ""
+    using Gear = CANSignal<15, 8, ByteOrder::Motorola>;
+};
+
+} // namespace EcuSignals
+// Engine status layout (big endian, like most powertrain networks):
+// [RPM High, RPM Low, Throttle, Coolant+40, 0, 0, 0, 0]
+
+// TCU command layout:
+// [Torque request (Nm), Gear, 0, 0, 0, 0, 0, 0]
@@ -0,0 +1,184 @@
+#include "SocketCANBackend.h"
+#include <iostream>
+
+#ifdef __linux__
+
+#include <array>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <net/if.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <linux/can.h>
+#include <linux/can/raw.h>
+
+// Every buffer the batched syscalls touch, allocated once up front
+struct SocketCANBackend::Batch {
+    std::array<can_frame, BatchSize> txFrames;
+    std::array<iovec, BatchSize> txIov;
+    std::array<mmsghdr, BatchSize> txMsgs;
+    size_t txCount = 0;     // Frames staged in txFrames
+    size_t txSent = 0;      // ...of which the kernel has already taken
+
+    std::array<can_frame, BatchSize> rxFrames;
+    std::array<iovec, BatchSize> rxIov;
+    std::array<mmsghdr, BatchSize> rxMsgs;
+    std::array<std::array<char, CMSG_SPACE(sizeof(timespec))>, BatchSize> rxControl;
+};
+
+SocketCANBackend::SocketCANBackend(const std::string& interfaceName)
+    : batch(new Batch{}) {
+
+    // Point every message header at its frame once, so poll() only fills data
+    for (size_t i = 0; i < BatchSize; i++) {
+        batch->txIov[i] = { &batch->txFrames[i], sizeof(can_frame) };
+        batch->txMsgs[i].msg_hdr.msg_iov = &batch->txIov[i];
+        batch->txMsgs[i].msg_hdr.msg_iovlen = 1;
+
+        batch->rxIov[i] = { &batch->rxFrames[i], sizeof(can_frame) };
+        batch->rxMsgs[i].msg_hdr.msg_iov = &batch->rxIov[i];
+        batch->rxMsgs[i].msg_hdr.msg_iovlen = 1;
+        batch->rxMsgs[i].msg_hdr.msg_control = batch->rxControl[i].data();
+    }
+
+    socketFd = socket(PF_CAN, SOCK_RAW, CAN_RAW);
+    if (socketFd < 0) {
+        std::cerr << "[SocketCAN] Error: Could not open CAN socket (" << std::strerror(errno) << ")\n";
+        return;
+    }
+
+    ifreq ifr{};
+    std::strncpy(ifr.ifr_name, interfaceName.c_str(), IFNAMSIZ - 1);
+    sockaddr_can addr{};
+    addr.can_family = AF_CAN;
+
+    int enable = 1;
+    bool attached = ioctl(socketFd, SIOCGIFINDEX, &ifr) >= 0;
+    if (attached) {
+        addr.can_ifindex = ifr.ifr_ifindex;
+        attached = bind(socketFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) >= 0 &&
+                   setsockopt(socketFd, SOL_SOCKET, SO_TIMESTAMPNS, &enable, sizeof(enable)) >= 0;
+    }
+    if (!attached) {
+        std::cerr << "[SocketCAN] Error: Could not attach to " << interfaceName
+                  << " (" << std::strerror(errno) << ")\n";
+        close(socketFd);
+        socketFd = -1;
+        return;
+    }
+
+    std::cout << "[SocketCAN] Attached to " << interfaceName << "\n";
+}
+
+SocketCANBackend::~SocketCANBackend() {
+    if (socketFd >= 0) close(socketFd);
+}
+
+void SocketCANBackend::transmit(const CANMessage& msg) {
+    if (!txQueue.tryPush(msg)) {
+        txDropCount.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void SocketCANBackend::flushTx() {
+    for (;;) {
+        // Stage the next batch once the previous one has gone out completely
+        if (batch->txSent == batch->txCount) {
+            batch->txCount = 0;
+            batch->txSent = 0;
+
+            CANMessage msg;
+            while (batch->txCount < BatchSize && txQueue.tryPop(msg)) {
+                can_frame& frame = batch->txFrames[batch->txCount++];
+                frame = {};
+                frame.can_id = msg.id > CAN_SFF_MASK ? (msg.id & CAN_EFF_MASK) | CAN_EFF_FLAG : msg.id;
+                frame.can_dlc = std::min<uint8_t>(msg.dlc, 8);
+                std::memcpy(frame.data, msg.data.data(), frame.can_dlc);
+            }
+            if (batch->txCount == 0) return;
+        }
+
+        int sent = sendmmsg(socketFd, &batch->txMsgs[batch->txSent],
+                            static_cast<unsigned>(batch->txCount - batch->txSent), MSG_DONTWAIT);
+        if (sent < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK || errno == ENOBUFS) {
+                return; // Kernel queue full: keep the batch and retry on the next poll
+            }
+            txDropCount.fetch_add(batch->txCount - batch->txSent, std::memory_order_relaxed);
+            batch->txSent = batch->txCount;
+            continue;
+        }
+
+        batch->txSent += static_cast<size_t>(sent);
+        if (batch->txSent < batch->txCount) return; // Partial send: kernel is full
+    }
+}
+
+size_t SocketCANBackend::poll(CANMessage* out, size_t maxCount) {
+    if (socketFd < 0) return 0;
+
+    flushTx();
+
+    size_t wanted = std::min(maxCount, BatchSize);
+    if (wanted == 0) return 0;
+
+    for (size_t i = 0; i < wanted; i++) {
+        batch->rxMsgs[i].msg_hdr.msg_controllen = batch->rxControl[i].size();
+        batch->rxMsgs[i].msg_len = 0;
+    }
+
+    int received = recvmmsg(socketFd, batch->rxMsgs.data(), static_cast<unsigned>(wanted), MSG_DONTWAIT, nullptr);
+    if (received <= 0) return 0;
+
+    // Kernel timestamps are CLOCK_REALTIME; shift them onto the steady clock
+    auto steadyNow = std::chrono::steady_clock::now();
+    auto realNow = std::chrono::system_clock::now().time_since_epoch();
+
+    size_t count = 0;
+    for (int i = 0; i < received; i++) {
+        const can_frame& frame = batch->rxFrames[i];
+        if (frame.can_id & (CAN_ERR_FLAG | CAN_RTR_FLAG)) continue;
+
+        CANMessage& msg = out[count++];
+        msg.id = (frame.can_id & CAN_EFF_FLAG) ? (frame.can_id & CAN_EFF_MASK) : (frame.can_id & CAN_SFF_MASK);
+        msg.dlc = std::min<uint8_t>(frame.can_dlc, 8);
+        msg.data.fill(0);
+        std::memcpy(msg.data.data(), frame.data, msg.dlc);
+        msg.timestamp = steadyNow;
+
+        msghdr& hdr = batch->rxMsgs[i].msg_hdr;
+        for (cmsghdr* c = CMSG_FIRSTHDR(&hdr); c; c = CMSG_NXTHDR(&hdr, c)) {
+            if (c->cmsg_level == SOL_SOCKET && c->cmsg_type == SO_TIMESTAMPNS) {
+                timespec ts;
+                std::memcpy(&ts, CMSG_DATA(c), sizeof(ts));
+                auto kernelTime = std::chrono::seconds(ts.tv_sec) + std::chrono::nanoseconds(ts.tv_nsec);
+                msg.timestamp = steadyNow - std::chrono::duration_cast<std::chrono::steady_clock::duration>(realNow - kernelTime);
+            }
+        }
+    }
+    return count;
+}
+
+#else // !__linux__
+
+struct SocketCANBackend::Batch {};
+
+SocketCANBackend::SocketCANBackend(const std::string& interfaceName) {
+    std::cerr << "[SocketCAN] Error: SocketCAN is only available on Linux (" << interfaceName << ")\n";
+}
+
+SocketCANBackend::~SocketCANBackend() = default;
+
+void SocketCANBackend::transmit(const CANMessage&) {
+    txDropCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+size_t SocketCANBackend::poll(CANMessage*, size_t) {
+    return 0;
+}
+
+void SocketCANBackend::flushTx() {}
+
+#endif
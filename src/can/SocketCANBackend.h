@@ -0,0 +1,39 @@
+#pragma once
+#include <atomic>
+#include <memory>
+#include <string>
+#include <cstdint>
+#include "CANBackend.h"
+#include "../common/RingBuffer.h"
+
+// Linux SocketCAN transport (e.g. vcan0), so candump/cansniffer and other tools
+// can watch and inject traffic. Frames are batched: transmit() only queues,
+// and poll() moves whole batches with one sendmmsg()/recvmmsg() each.
+// Received frames carry the kernel's receive timestamp.
+// On other platforms isOpen() is always false.
+class SocketCANBackend : public CANBackend {
+public:
+    static constexpr size_t BatchSize = 64;       // Frames per sendmmsg/recvmmsg
+    static constexpr size_t TxQueueCapacity = 4096;
+
+    explicit SocketCANBackend(const std::string& interfaceName);
+    ~SocketCANBackend() override;
+
+    bool isOpen() const { return socketFd >= 0; }
+
+    void transmit(const CANMessage& msg) override;
+    size_t poll(CANMessage* out, size_t maxCount) override;
+
+    // Frames dropped because the TX queue was full or the kernel refused them
+    uint64_t getTxDropCount() const { return txDropCount.load(std::memory_order_relaxed); }
+
+private:
+    struct Batch;                           // Preallocated syscall buffers (platform specific)
+
+    void flushTx();
+
+    int socketFd = -1;
+    std::unique_ptr<Batch> batch;
+    RingBuffer<CANMessage, TxQueueCapacity> txQueue;
+    std::atomic<uint64_t> txDropCount{0};
+};
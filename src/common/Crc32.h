@@ -0,0 +1,32 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// CRC-32 (IEEE 802.3, reflected 0xEDB88320), the same as zlib's crc32().
+// The lookup table is built at compile time.
+namespace crc32_detail {
+    constexpr std::array<uint32_t, 256> makeTable() {
+        std::array<uint32_t, 256> table{};
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; k++) {
+                c = (c & 1) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
+            }
+            table[i] = c;
+        }
+        return table;
+    }
+
+    constexpr std::array<uint32_t, 256> Table = makeTable();
+}
+
+// Pass a previous result as 'crc' to continue over several buffers
+inline uint32_t crc32(const void* data, size_t length, uint32_t crc = 0) {
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    crc = ~crc;
+    for (size_t i = 0; i < length; i++) {
+        crc = crc32_detail::Table[(crc ^ p[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
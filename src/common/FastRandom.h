@@ -0,0 +1,43 @@
+#pragma once
+#include <cstdint>
+
+// xoshiro128+ (Blackman & Vigna): 16 bytes of state and a few instructions per
+// number. Plenty for simulated sensor noise; not for anything cryptographic.
+// Each instance is an independent stream, so every owner can be seeded on its
+// own and replayed exactly.
+class FastRandom {
+public:
+    explicit FastRandom(uint64_t seed) {
+        // splitmix64 spreads any seed (including 0) over the whole state
+        for (int i = 0; i < 4; i += 2) {
+            uint64_t z = (seed += 0x9E3779B97F4A7C15ull);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            z ^= z >> 31;
+            state[i] = static_cast<uint32_t>(z);
+            state[i + 1] = static_cast<uint32_t>(z >> 32);
+        }
+    }
+
+    uint32_t next() {
+        uint32_t result = state[0] + state[3];
+        uint32_t t = state[1] << 9;
+
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= t;
+        state[3] = (state[3] << 11) | (state[3] >> 21);
+        return result;
+    }
+
+    // [0, 1) from the top 24 bits (the low bits of xoshiro128+ are weaker)
+    float nextFloat() { return static_cast<float>(next() >> 8) * (1.0f / 16777216.0f); }
+
+    // [min, max)
+    float uniform(float min, float max) { return min + (max - min) * nextFloat(); }
+
+private:
+    uint32_t state[4];
+};
@@ -0,0 +1,59 @@
+#pragma once
+#include <array>
+#include <functional>
+#include <utility>
+#include <cstddef>
+
+// Binary min-heap in a fixed array: push/pop never allocate. For hot event
+// queues whose worst-case size is known up front.
+// Compare(a, b) == true means a comes out before b.
+template <typename T, size_t Capacity, typename Compare = std::less<T>>
+class FixedHeap {
+public:
+    bool empty() const { return count == 0; }
+    size_t size() const { return count; }
+    static constexpr size_t capacity() { return Capacity; }
+
+    const T& top() const { return items[0]; }
+
+    // Returns false (and drops the item) when full
+    bool push(const T& item) {
+        if (count == Capacity) return false;
+
+        // Sift up
+        size_t i = count++;
+        while (i > 0) {
+            size_t parent = (i - 1) / 2;
+            if (!before(item, items[parent])) break;
+            items[i] = items[parent];
+            i = parent;
+        }
+        items[i] = item;
+        return true;
+    }
+
+    void pop() {
+        if (count == 0) return;
+        T last = items[--count];
+
+        // Sift the last item down from the root
+        size_t i = 0;
+        for (;;) {
+            size_t child = 2 * i + 1;
+            if (child >= count) break;
+            if (child + 1 < count && before(items[child + 1], items[child])) child++;
+            if (!before(items[child], last)) break;
+            items[i] = items[child];
+            i = child;
+        }
+        items[i] = last;
+    }
+
+    void clear() { count = 0; }
+
+private:
+    bool before(const T& a, const T& b) const { return Compare()(a, b); }
+
+    std::array<T, Capacity> items{};
+    size_t count = 0;
+};
@@ -0,0 +1,176 @@
+#include "MappedFile.h"
+#include <iostream>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+#ifdef _WIN32
+
+bool MappedFile::open(const std::string& path, Mode mode, size_t createSize) {
+    close();
+    bool writable = (mode == Mode::ReadWrite);
+
+    HANDLE file = CreateFileA(path.c_str(),
+                              writable ? (GENERIC_READ | GENERIC_WRITE) : GENERIC_READ,
+                              FILE_SHARE_READ, nullptr,
+                              (writable && createSize > 0) ? OPEN_ALWAYS : OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        std::cerr << "[MappedFile] Error: Could not open " << path << "\n";
+        return false;
+    }
+
+    LARGE_INTEGER fileSize;
+    GetFileSizeEx(file, &fileSize);
+    size_t size = static_cast<size_t>(fileSize.QuadPart);
+    if (writable && size < createSize) size = createSize; // CreateFileMapping grows the file
+
+    if (size == 0) {
+        std::cerr << "[MappedFile] Error: " << path << " is empty\n";
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, writable ? PAGE_READWRITE : PAGE_READONLY,
+                                        static_cast<DWORD>(uint64_t(size) >> 32),
+                                        static_cast<DWORD>(size & 0xFFFFFFFFu), nullptr);
+    void* view = mapping ? MapViewOfFile(mapping, writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, size) : nullptr;
+    if (!view) {
+        std::cerr << "[MappedFile] Error: Could not map " << path << "\n";
+        if (mapping) CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    fileHandle = file;
+    mappingHandle = mapping;
+    base = static_cast<uint8_t*>(view);
+    length = size;
+    return true;
+}
+
+void MappedFile::close() {
+    if (base) UnmapViewOfFile(base);
+    if (mappingHandle) CloseHandle(mappingHandle);
+    if (fileHandle) CloseHandle(fileHandle);
+    base = nullptr;
+    length = 0;
+    mappingHandle = nullptr;
+    fileHandle = nullptr;
+}
+
+bool MappedFile::flush(size_t offset, size_t count) {
+    if (!base) return false;
+    return FlushViewOfFile(base + offset, count) != 0;
+}
+
+// Windows read-ahead on mapped views is good enough for sequential readers
+void MappedFile::prefetch(size_t, size_t) const {}
+
+void MappedFile::adviseSequential() const {}
+
+void MappedFile::release(size_t, size_t) const {}
+
+#else
+
+bool MappedFile::open(const std::string& path, Mode mode, size_t createSize) {
+    close();
+    bool writable = (mode == Mode::ReadWrite);
+
+    int flags = writable ? O_RDWR : O_RDONLY;
+    if (writable && createSize > 0) flags |= O_CREAT;
+
+    int file = ::open(path.c_str(), flags, 0644);
+    if (file < 0) {
+        std::cerr << "[MappedFile] Error: Could not open " << path << "\n";
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(file, &st) < 0) {
+        ::close(file);
+        return false;
+    }
+
+    size_t size = static_cast<size_t>(st.st_size);
+    if (writable && size < createSize) {
+        if (ftruncate(file, static_cast<off_t>(createSize)) < 0) {
+            std::cerr << "[MappedFile] Error: Could not grow " << path << "\n";
+            ::close(file);
+            return false;
+        }
+        size = createSize;
+    }
+
+    if (size == 0) {
+        std::cerr << "[MappedFile] Error: " << path << " is empty\n";
+        ::close(file);
+        return false;
+    }
+
+    void* view = mmap(nullptr, size, writable ? (PROT_READ | PROT_WRITE) : PROT_READ, MAP_SHARED, file, 0);
+    if (view == MAP_FAILED) {
+        std::cerr << "[MappedFile] Error: Could not map " << path << "\n";
+        ::close(file);
+        return false;
+    }
+
+    fd = file;
+    base = static_cast<uint8_t*>(view);
+    length = size;
+    return true;
+}
+
+void MappedFile::close() {
+    if (base) munmap(base, length);
+    if (fd >= 0) ::close(fd);
+    base = nullptr;
+    length = 0;
+    fd = -1;
+}
+
+bool MappedFile::flush(size_t offset, size_t count) {
+    if (!base) return false;
+
+    // msync wants a page-aligned start
+    size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    size_t start = offset - (offset % page);
+    return msync(base + start, count + (offset - start), MS_SYNC) == 0;
+}
+
+void MappedFile::prefetch(size_t offset, size_t count) const {
+    if (!base || offset >= length) return;
+    if (count > length - offset) count = length - offset;
+
+    size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    size_t start = offset - (offset % page);
+    madvise(base + start, count + (offset - start), MADV_WILLNEED);
+}
+
+void MappedFile::adviseSequential() const {
+    if (base) madvise(base, length, MADV_SEQUENTIAL);
+}
+
+void MappedFile::release(size_t offset, size_t count) const {
+    if (!base || offset >= length) return;
+    if (count > length - offset) count = length - offset;
+
+    // Only whole pages inside the range
+    size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    size_t start = (offset + page - 1) / page * page;
+    size_t end = (offset + count) / page * page;
+    if (end > start) madvise(base + start, end - start, MADV_DONTNEED);
+}
+
+#endif
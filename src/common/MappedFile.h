@@ -0,0 +1,51 @@
+#pragma once
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+// A file mapped into memory. Readers get the whole file as one pointer and let
+// the OS page it in on demand, so multi-gigabyte files cost no up-front load.
+class MappedFile {
+public:
+    enum class Mode { ReadOnly, ReadWrite };
+
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Map an existing file. In ReadWrite mode with createSize > 0 the file is
+    // created if missing and grown (zero-filled) to at least createSize bytes.
+    bool open(const std::string& path, Mode mode, size_t createSize = 0);
+    void close();
+
+    bool isOpen() const { return base != nullptr; }
+    uint8_t* data() { return base; }
+    const uint8_t* data() const { return base; }
+    size_t size() const { return length; }
+
+    // Write a dirty range back to disk (ReadWrite only)
+    bool flush(size_t offset, size_t count);
+
+    // Hint that [offset, offset + count) will be read soon
+    void prefetch(size_t offset, size_t count) const;
+
+    // Hint that the mapping will be read front to back
+    void adviseSequential() const;
+
+    // Hint that [offset, offset + count) won't be read again, so its pages can
+    // be dropped from memory (ReadOnly; they are re-read from the file if touched)
+    void release(size_t offset, size_t count) const;
+
+private:
+    uint8_t* base = nullptr;
+    size_t length = 0;
+
+#ifdef _WIN32
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+#else
+    int fd = -1;
+#endif
+};
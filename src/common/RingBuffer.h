@@ -0,0 +1,94 @@
+#pragma once
+#include <atomic>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+
+// Bounded lock-free ring buffer (Vyukov-style sequence per slot).
+// Any number of threads may push and pop concurrently; the usual use here is
+// many producers (tasks sending frames) and one consumer (the reader).
+// All storage is allocated once in the constructor: push/pop never allocate.
+template <typename T, size_t Capacity>
+class RingBuffer {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                  "RingBuffer capacity must be a power of two");
+
+public:
+    RingBuffer() : cells(new Cell[Capacity]) {
+        for (size_t i = 0; i < Capacity; i++) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    RingBuffer(const RingBuffer&) = delete;
+    RingBuffer& operator=(const RingBuffer&) = delete;
+
+    // Returns false (and leaves the buffer untouched) when full
+    bool tryPush(const T& value) {
+        size_t pos = enqueuePos.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells[pos & Mask];
+            size_t seq = cell.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+
+            if (diff == 0) {
+                // Slot is free: claim it
+                if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    cell.value = value;
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false; // Consumer hasn't freed this slot yet -> full
+            } else {
+                pos = enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Returns false when empty
+    bool tryPop(T& out) {
+        size_t pos = dequeuePos.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells[pos & Mask];
+            size_t seq = cell.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+
+            if (diff == 0) {
+                if (dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    out = cell.value;
+                    // Hand the slot back to producers one lap later
+                    cell.sequence.store(pos + Capacity, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false; // Nothing published here yet -> empty
+            } else {
+                pos = dequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Pop up to maxCount items straight into the caller's buffer
+    size_t drain(T* out, size_t maxCount) {
+        size_t n = 0;
+        while (n < maxCount && tryPop(out[n])) n++;
+        return n;
+    }
+
+    static constexpr size_t capacity() { return Capacity; }
+
+private:
+    static constexpr size_t Mask = Capacity - 1;
+
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    std::unique_ptr<Cell[]> cells;
+
+    // Separate cache lines so producers and the consumer don't false-share
+    alignas(64) std::atomic<size_t> enqueuePos{0};
+    alignas(64) std::atomic<size_t> dequeuePos{0};
+};
@@ -0,0 +1,50 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+// Non-owning view of a contiguous run of T (pointer + length), for block
+// interfaces until the project moves to C++20's std::span. Span<T> converts
+// to Span<const T>, so a function taking Span<const float> accepts arrays,
+// vectors and writable spans alike.
+template <typename T>
+class Span {
+public:
+    constexpr Span() : ptr(nullptr), count(0) {}
+    constexpr Span(T* data, size_t size) : ptr(data), count(size) {}
+
+    template <size_t N>
+    constexpr Span(T (&array)[N]) : ptr(array), count(N) {}
+
+    template <typename U, size_t N, typename = std::enable_if_t<std::is_convertible<U (*)[], T (*)[]>::value>>
+    constexpr Span(std::array<U, N>& array) : ptr(array.data()), count(N) {}
+
+    template <typename U, size_t N, typename = std::enable_if_t<std::is_convertible<const U (*)[], T (*)[]>::value>>
+    constexpr Span(const std::array<U, N>& array) : ptr(array.data()), count(N) {}
+
+    template <typename U, typename = std::enable_if_t<std::is_convertible<U (*)[], T (*)[]>::value>>
+    Span(std::vector<U>& vector) : ptr(vector.data()), count(vector.size()) {}
+
+    template <typename U, typename = std::enable_if_t<std::is_convertible<const U (*)[], T (*)[]>::value>>
+    Span(const std::vector<U>& vector) : ptr(vector.data()), count(vector.size()) {}
+
+    // Span<float> -> Span<const float>
+    template <typename U, typename = std::enable_if_t<std::is_convertible<U (*)[], T (*)[]>::value>>
+    constexpr Span(Span<U> other) : ptr(other.data()), count(other.size()) {}
+
+    constexpr T* data() const { return ptr; }
+    constexpr size_t size() const { return count; }
+    constexpr bool empty() const { return count == 0; }
+
+    constexpr T& operator[](size_t i) const { return ptr[i]; }
+    constexpr T* begin() const { return ptr; }
+    constexpr T* end() const { return ptr + count; }
+
+    constexpr Span first(size_t n) const { return { ptr, n }; }
+    constexpr Span subspan(size_t offset, size_t n) const { return { ptr + offset, n }; }
+
+private:
+    T* ptr;
+    size_t count;
+};
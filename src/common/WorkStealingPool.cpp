@@ -0,0 +1,100 @@
+#include "WorkStealingPool.h"
+#include <algorithm>
+
+// Index of the pool worker running on this thread, or NotAWorker
+static const size_t NotAWorker = static_cast<size_t>(-1);
+static thread_local const WorkStealingPool* currentPool = nullptr;
+static thread_local size_t currentWorker = NotAWorker;
+
+WorkStealingPool::WorkStealingPool(unsigned threads) {
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+
+    for (unsigned i = 0; i < threads; i++) {
+        workers.push_back(std::make_unique<Worker>());
+    }
+    for (size_t i = 0; i < workers.size(); i++) {
+        workers[i]->thread = std::thread(&WorkStealingPool::workerLoop, this, i);
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    wait();
+    {
+        std::lock_guard<std::mutex> lock(idleMutex);
+        stopping = true;
+    }
+    jobAvailable.notify_all();
+    for (auto& w : workers) w->thread.join();
+}
+
+void WorkStealingPool::submit(std::function<void()> job) {
+    size_t target = (currentPool == this) ? currentWorker
+                                          : nextQueue.fetch_add(1, std::memory_order_relaxed) % workers.size();
+
+    // Counted before it is visible, so a worker that grabs it straight away
+    // never takes the count below zero
+    unfinished.fetch_add(1);
+    {
+        std::lock_guard<std::mutex> lock(idleMutex);
+        queued.fetch_add(1);
+    }
+    {
+        std::lock_guard<std::mutex> lock(workers[target]->mutex);
+        workers[target]->jobs.push_back(std::move(job));
+    }
+    jobAvailable.notify_one();
+}
+
+void WorkStealingPool::wait() {
+    std::unique_lock<std::mutex> lock(idleMutex);
+    allDone.wait(lock, [this] { return unfinished.load() == 0; });
+}
+
+bool WorkStealingPool::takeJob(size_t self, std::function<void()>& job) {
+    // Own queue first, newest job
+    {
+        Worker& own = *workers[self];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.jobs.empty()) {
+            job = std::move(own.jobs.back());
+            own.jobs.pop_back();
+            return true;
+        }
+    }
+
+    // Then steal the oldest job from the others, starting with the next worker
+    for (size_t k = 1; k < workers.size(); k++) {
+        Worker& victim = *workers[(self + k) % workers.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.jobs.empty()) {
+            job = std::move(victim.jobs.front());
+            victim.jobs.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkStealingPool::workerLoop(size_t self) {
+    currentPool = this;
+    currentWorker = self;
+
+    for (;;) {
+        std::function<void()> job;
+        if (takeJob(self, job)) {
+            queued.fetch_sub(1);
+            job();
+
+            if (unfinished.fetch_sub(1) == 1) {
+                std::lock_guard<std::mutex> lock(idleMutex);
+                allDone.notify_all();
+            }
+            continue;
+        }
+
+        // Nothing anywhere: sleep until a job is queued
+        std::unique_lock<std::mutex> lock(idleMutex);
+        jobAvailable.wait(lock, [this] { return queued.load() > 0 || stopping; });
+        if (stopping && queued.load() == 0) break;
+    }
+}
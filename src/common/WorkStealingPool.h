@@ -0,0 +1,56 @@
+#pragma once
+#include <vector>
+#include <deque>
+#include <memory>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+
+// Fixed set of worker threads, each with its own job queue. A worker runs its
+// own jobs newest first (they are the ones still warm in its cache) and, when
+// it runs dry, steals the oldest job from another worker. Uneven jobs, such as
+// sim instances that stall early versus ones that run the full duration,
+// then keep every core busy until the very end.
+class WorkStealingPool {
+public:
+    // threads = 0: one per core
+    explicit WorkStealingPool(unsigned threads = 0);
+
+    // Finishes every queued job first
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    // Queue a job. From a worker it goes on that worker's own queue; from
+    // outside, the queues are filled round-robin.
+    void submit(std::function<void()> job);
+
+    // Block until every job submitted so far has finished
+    void wait();
+
+    unsigned size() const { return static_cast<unsigned>(workers.size()); }
+
+private:
+    struct Worker {
+        std::deque<std::function<void()>> jobs;
+        std::mutex mutex;
+        std::thread thread;
+    };
+
+    void workerLoop(size_t self);
+    bool takeJob(size_t self, std::function<void()>& job);
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::atomic<size_t> nextQueue{0};
+
+    std::atomic<size_t> queued{0};      // Jobs sitting in some queue
+    std::atomic<size_t> unfinished{0};  // Jobs submitted but not yet done
+    bool stopping = false;
+    std::mutex idleMutex;
+    std::condition_variable jobAvailable;
+    std::condition_variable allDone;
+};
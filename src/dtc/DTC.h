@@ -1,11 +1,77 @@
 #pragma once
 #include <string>
+#include <cstdint>
+
+// A DTC in its standard two-byte form (SAE J2012), e.g. "P0217" -> 0x0217:
+//   bits 15-14  system      P=0, C=1, B=2, U=3
+//   bits 13-12  first digit 0-3
+//   bits 11-0   three hex digits
+using DTCCode = uint16_t;
+
+namespace dtc_detail {
+    constexpr int hexValue(char c) {
+        return (c >= '0' && c <= '9') ? c - '0'
+             : (c >= 'A' && c <= 'F') ? c - 'A' + 10
+             : (c >= 'a' && c <= 'f') ? c - 'a' + 10
+             : -1;
+    }
+    constexpr int systemValue(char c) {
+        return (c == 'P' || c == 'p') ? 0 : (c == 'C' || c == 'c') ? 1
+             : (c == 'B' || c == 'b') ? 2 : (c == 'U' || c == 'u') ? 3 : -1;
+    }
+}
+
+// Parse "P0217"-style text. Returns false if it isn't a valid code.
+constexpr bool parseDTC(const char* text, DTCCode& out) {
+    if (!text) return false;
+    int system = dtc_detail::systemValue(text[0]);
+    if (system < 0) return false;
+
+    int first = (text[1] >= '0' && text[1] <= '3') ? text[1] - '0' : -1;
+    if (first < 0) return false;
+
+    int value = (system << 14) | (first << 12);
+    for (int i = 2; i < 5; i++) {
+        int digit = dtc_detail::hexValue(text[i]);
+        if (digit < 0) return false;
+        value |= digit << (4 * (4 - i));
+    }
+    if (text[5] != '\0') return false;
+
+    out = static_cast<DTCCode>(value);
+    return true;
+}
+
+// Compile-time code constant: constexpr DTCCode P0217 = makeDTC("P0217");
+// Invalid text yields 0 ("P0000").
+constexpr DTCCode makeDTC(const char* text) {
+    DTCCode code = 0;
+    return parseDTC(text, code) ? code : 0;
+}
+
+// Writes "P0217" plus terminator into out (6 chars)
+inline void formatDTC(DTCCode code, char out[6]) {
+    static const char systems[4] = { 'P', 'C', 'B', 'U' };
+    static const char hex[] = "0123456789ABCDEF";
+    out[0] = systems[code >> 14];
+    out[1] = static_cast<char>('0' + ((code >> 12) & 0x3));
+    out[2] = hex[(code >> 8) & 0xF];
+    out[3] = hex[(code >> 4) & 0xF];
+    out[4] = hex[code & 0xF];
+    out[5] = '\0';
+}
+
+inline std::string dtcToString(DTCCode code) {
+    char text[6];
+    formatDTC(code, text);
+    return text;
+}
 
 struct DTC {
-    std::string code;      // e.g., "P0120"
+    DTCCode code;          // e.g., makeDTC("P0120")
     std::string message;   // e.g., "Throttle Position Sensor Fault"
     bool active = false;
 };
 
 
-// Diagnostic Trouble Codes (DTC) System
\ No newline at end of file
+// Diagnostic Trouble Codes (DTC) System
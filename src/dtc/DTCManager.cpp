@@ -1,65 +1,127 @@
 #include "DTCManager.h"
-#include "../memory/FlashMemory.h" // <--- NEW
+#include <iostream>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+DTCManager::DTCManager(const std::string& flashImage) : flash(flashImage), slotOf(65536) {
+    for (auto& slot : slotOf) slot.store(NoSlot, std::memory_order_relaxed);
+    codes.reserve(MaxFaults);
+    messages.reserve(MaxFaults);
 
-DTCManager::DTCManager() {
     // Upon startup, check Flash for old codes
-    faults = FlashMemory::loadDTCs();
+    for (const auto& f : flash.loadDTCs()) {
+        if (!registerFault(f.code, f.message)) break;
+        uint16_t slot = lookupSlot(f.code);
+        activeBits[slot / 64].fetch_or(uint64_t(1) << (slot % 64), std::memory_order_relaxed);
+    }
 }
 
-void DTCManager::addFault(const std::string& code, const std::string& message) {
-    for (auto& f : faults) {
-        if (f.code == code) {
-            // Case A: Fault already exists, just wake it up
-            if (!f.active) {
-                f.active = true;
-                FlashMemory::saveDTCs(faults); // <--- 3. ADD THIS LINE (Save on update)
-            }
-            return;
-        }
+bool DTCManager::registerFault(DTCCode code, const std::string& message) {
+    std::lock_guard<std::mutex> lock(faultMutex);
+    uint16_t known = slotOf[code].load(std::memory_order_relaxed);   // Only written under this lock
+    if (known != NoSlot) {
+        // Already known (e.g., restored from flash): just fill in the text
+        if (messages[known].empty()) messages[known] = message;
+        return true;
+    }
+    if (codes.size() >= MaxFaults) {
+        std::cerr << "[DTCManager] Error: fault table full, cannot register " << dtcToString(code) << "\n";
+        return false;
     }
-    
-    // Case B: Brand new fault
-    faults.push_back({ code, message, true });
-    FlashMemory::saveDTCs(faults); // <--- 4. ADD THIS LINE (Save on new)
+
+    codes.push_back(code);
+    messages.push_back(message);
+    // Publish last: a lock-free reader that sees the slot also sees its code
+    slotOf[code].store(static_cast<uint16_t>(codes.size() - 1), std::memory_order_release);
+    return true;
 }
 
-void DTCManager::clearFault(const std::string& code) {
-    bool changed = false;
-    for (auto& f : faults) {
-        if (f.code == code && f.active) {
-            f.active = false;
-            changed = true;
-        }
+uint16_t DTCManager::slotFor(DTCCode code) {
+    uint16_t slot = lookupSlot(code);
+    if (slot == NoSlot && registerFault(code, "")) slot = lookupSlot(code);
+    return slot;
+}
+
+void DTCManager::addFault(DTCCode code) {
+    uint16_t slot = slotFor(code);
+    if (slot == NoSlot) return;
+
+    uint64_t bit = uint64_t(1) << (slot % 64);
+    uint64_t before = activeBits[slot / 64].fetch_or(bit, std::memory_order_acq_rel);
+    if (before & bit) return; // Already active: nothing changed, nothing to save
+
+    if (activationHook) activationHook(code);
+    commitSlot(slot);
+}
+
+void DTCManager::clearFault(DTCCode code) {
+    uint16_t slot = lookupSlot(code);
+    if (slot == NoSlot) return;
+
+    uint64_t bit = uint64_t(1) << (slot % 64);
+    uint64_t before = activeBits[slot / 64].fetch_and(~bit, std::memory_order_acq_rel);
+    if (!(before & bit)) return;
+
+    commitSlot(slot);
+}
+
+void DTCManager::commitSlot(uint16_t slot) {
+    // Commit the state as it is now, under the lock, so racing set/clear
+    // calls can't reach the journal in the opposite order
+    std::lock_guard<std::mutex> lock(faultMutex);
+    flash.commitDTC(codes[slot], isSlotActive(slot), messages[slot]);
+}
+
+bool DTCManager::isSlotActive(uint16_t slot) const {
+    return (activeBits[slot / 64].load(std::memory_order_acquire) >> (slot % 64)) & 1;
+}
+
+bool DTCManager::isActive(DTCCode code) const {
+    uint16_t slot = lookupSlot(code);
+    return slot != NoSlot && isSlotActive(slot);
+}
+
+// Index of the lowest set bit; `bits` must be non-zero
+static inline unsigned lowestSetBit(uint64_t bits) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, bits);
+    return static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_ctzll(bits));
+#endif
+}
+
+bool DTCManager::getFirstActive(DTCCode& code) const {
+    for (size_t w = 0; w < Words; w++) {
+        uint64_t bits = activeBits[w].load(std::memory_order_acquire);
+        if (!bits) continue;
+
+        code = codes[w * 64 + lowestSetBit(bits)];
+        return true;
     }
-    
-    // <--- 5. Optional: Add this to save when you clear codes too
-    if (changed) {
-        FlashMemory::saveDTCs(faults); 
+    return false;
+}
+
+size_t DTCManager::getActiveCount() const {
+    size_t count = 0;
+    for (const auto& word : activeBits) {
+        uint64_t bits = word.load(std::memory_order_relaxed);
+        while (bits) {
+            bits &= bits - 1;
+            count++;
+        }
     }
+    return count;
 }
 
-const std::vector<DTC>& DTCManager::getActiveFaults() const {
+std::vector<DTC> DTCManager::getFaultsSnapshot() const {
+    std::lock_guard<std::mutex> lock(faultMutex);
+    std::vector<DTC> faults;
+    faults.reserve(codes.size());
+    for (size_t slot = 0; slot < codes.size(); slot++) {
+        faults.push_back({ codes[slot], messages[slot], isSlotActive(static_cast<uint16_t>(slot)) });
+    }
     return faults;
 }
-
-// void DTCManager::addFault(const std::string& code, const std::string& message) {
-//     for (auto& f : faults) {
-//         if (f.code == code) {
-//             f.active = true;
-//             return;
-//         }
-//     }
-//     faults.push_back({ code, message, true });
-// }
-
-// void DTCManager::clearFault(const std::string& code) {
-//     for (auto& f : faults) {
-//         if (f.code == code)
-//             f.active = false;
-//     }
-// }
-
-// const std::vector<DTC>& DTCManager::getActiveFaults() const {
-//     return faults;
-// }
-
@@ -1,15 +1,68 @@
 #pragma once
+#include <array>
+#include <atomic>
 #include <vector>
+#include <string>
+#include <mutex>
+#include <functional>
+#include <cstdint>
 #include "DTC.h"
+#include "../memory/FlashMemory.h"
 
 class DTCManager {
 public:
-    DTCManager(); // Constructor to load faults from FlashMemory
-    void addFault(const std::string& code, const std::string& message);
-    void clearFault(const std::string& code);
-    const std::vector<DTC>& getActiveFaults() const;
+    // Size of the monitor catalogue
+    static constexpr size_t MaxFaults = 512;
+
+    // Loads faults from the flash image (one image per simulated ECU)
+    explicit DTCManager(const std::string& flashImage = "ecu_flash.img");
+
+    // Setup: add a monitor's code to the table. The message is stored once here
+    // and never copied on the hot path. Returns false if the table is full.
+    bool registerFault(DTCCode code, const std::string& message);
+
+    // Hot path: O(1) table lookup and one atomic bit operation. No strings, no
+    // allocation, no file I/O: a state change only queues a flash commit.
+    // Unregistered codes are added on the fly (with no message).
+    void addFault(DTCCode code);
+    void clearFault(DTCCode code);
+
+    bool isActive(DTCCode code) const;
+
+    // First registered active fault (lowest table slot, not lowest code), if any
+    bool getFirstActive(DTCCode& code) const;
+    size_t getActiveCount() const;
+
+    // Registered faults with their text, for printing and persistence (allocates).
+    // Safe to take from another scheduler band.
+    std::vector<DTC> getFaultsSnapshot() const;
+
+    // Called from addFault() each time a fault goes from inactive to active
+    // (e.g., FreezeFrameRecorder::trigger). Set during setup; must not block.
+    void setActivationHook(std::function<void(DTCCode)> hook) { activationHook = std::move(hook); }
+
+    // The NVRAM chip, for other users of its partitions (freeze frames, calibration)
+    FlashMemory& getFlash() { return flash; }
 
 private:
-    std::vector<DTC> faults;
-};
+    static constexpr uint16_t NoSlot = 0xFFFF;
+    static constexpr size_t Words = MaxFaults / 64;
+
+    uint16_t lookupSlot(DTCCode code) const { return slotOf[code].load(std::memory_order_acquire); }
+    uint16_t slotFor(DTCCode code);             // Registers unknown codes
+    bool isSlotActive(uint16_t slot) const;
+    void commitSlot(uint16_t slot);
+
+    FlashMemory flash;                          // Declared first: outlives the table and drains on exit
 
+    // Direct index: every 16-bit code -> table slot. Written under faultMutex
+    // (release), read lock-free on the hot path (acquire).
+    std::vector<std::atomic<uint16_t>> slotOf;
+    std::vector<DTCCode> codes;                 // Slot -> code (reserved up front, never reallocates)
+    std::vector<std::string> messages;          // Slot -> interned message text
+    std::array<std::atomic<uint64_t>, Words> activeBits{};  // One bit per slot
+
+    std::function<void(DTCCode)> activationHook;
+
+    mutable std::mutex faultMutex; // Guards registration and commit ordering
+};
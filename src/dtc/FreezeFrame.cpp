@@ -0,0 +1,140 @@
+#include "FreezeFrame.h"
+#include "../common/Crc32.h"
+#include <cstring>
+
+static const uint32_t SlotMagic = 0x5A524646; // "FFRZ"
+
+static_assert(sizeof(ECUData) % 8 == 0, "ECUData is stored raw in flash");
+
+FreezeFrameRecorder::FreezeFrameRecorder(FlashMemory& flash, uint16_t samplePeriodMs)
+    : flash(flash),
+      partition(flash.getPartition(FlashLayout::Partition::FreezeFrames)),
+      slotCount(flash.getPartitionSize(FlashLayout::Partition::FreezeFrames) / SlotSize) {
+    captured.samplePeriodMs = samplePeriodMs;
+
+    // Carry on after the newest stored frame, overwriting the oldest
+    bool any = false;
+    for (size_t s = 0; s < slotCount; s++) {
+        if (!isValid(s)) continue;
+        uint32_t seq = slotHeader(s)->sequence;
+        if (!any || seq >= nextSequence) {
+            nextSequence = seq + 1;
+            nextSlot = (s + 1) % slotCount;
+            any = true;
+        }
+    }
+}
+
+// --- Physics task ---
+
+void FreezeFrameRecorder::record(const ECUData& sample) {
+    history[head % HistorySamples] = sample;
+    head++;
+
+    if (!capturing) {
+        // Start a capture once the previous frame has been handed off
+        if (pendingTrigger.load(std::memory_order_relaxed) == NoTrigger ||
+            capturedReady.load(std::memory_order_acquire)) return;
+
+        captured.code = static_cast<DTCCode>(pendingTrigger.exchange(NoTrigger, std::memory_order_acquire));
+        captured.triggerTick = head;
+        captured.preSamples = static_cast<uint16_t>(head < FreezeFrame::PreSamples ? head : FreezeFrame::PreSamples);
+        triggerHead = head;
+        capturing = true;
+        return;
+    }
+
+    if (head - triggerHead < FreezeFrame::PostSamples) return;
+
+    // Window complete: copy it out of the ring, oldest first
+    uint64_t start = triggerHead - captured.preSamples;
+    size_t count = captured.preSamples + FreezeFrame::PostSamples;
+    for (size_t i = 0; i < count; i++) {
+        captured.samples[i] = history[(start + i) % HistorySamples];
+    }
+    capturing = false;
+    capturedReady.store(true, std::memory_order_release);
+}
+
+void FreezeFrameRecorder::trigger(DTCCode code) {
+    uint32_t expected = NoTrigger;
+    if (!pendingTrigger.compare_exchange_strong(expected, code, std::memory_order_release)) {
+        missedTriggers.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+// --- Housekeeping task ---
+
+const FreezeFrameRecorder::SlotHeader* FreezeFrameRecorder::slotHeader(size_t slot) const {
+    return reinterpret_cast<const SlotHeader*>(partition + slot * SlotSize);
+}
+
+bool FreezeFrameRecorder::isValid(size_t slot) const {
+    const SlotHeader* h = slotHeader(slot);
+    if (h->magic != SlotMagic || h->sampleCount > FreezeFrame::Samples) return false;
+
+    uint32_t crc = crc32(h, offsetof(SlotHeader, crc));
+    crc = crc32(h + 1, sizeof(ECUData) * h->sampleCount, crc);
+    return crc == h->crc;
+}
+
+void FreezeFrameRecorder::poll() {
+    if (!capturedReady.load(std::memory_order_acquire)) return;
+
+    if (partition && slotCount > 0) {
+        std::lock_guard<std::mutex> lock(partitionMutex);
+
+        SlotHeader h;
+        std::memset(&h, 0xFF, sizeof(h));
+        h.magic = SlotMagic;
+        h.sequence = nextSequence++;
+        h.triggerTick = captured.triggerTick;
+        h.code = captured.code;
+        h.samplePeriodMs = captured.samplePeriodMs;
+        h.preSamples = captured.preSamples;
+        h.sampleCount = static_cast<uint16_t>(captured.preSamples + FreezeFrame::PostSamples);
+
+        size_t sampleBytes = sizeof(ECUData) * h.sampleCount;
+        h.crc = crc32(&h, offsetof(SlotHeader, crc));
+        h.crc = crc32(captured.samples.data(), sampleBytes, h.crc);
+
+        // Erase the slot, then program it (header last, so a torn write fails the CRC)
+        uint8_t* dst = partition + nextSlot * SlotSize;
+        std::memset(dst, 0xFF, SlotSize);
+        std::memcpy(dst + sizeof(SlotHeader), captured.samples.data(), sampleBytes);
+        std::memcpy(dst, &h, sizeof(h));
+        flash.flushPartition(FlashLayout::Partition::FreezeFrames, nextSlot * SlotSize, SlotSize);
+
+        nextSlot = (nextSlot + 1) % slotCount;
+    }
+
+    capturedReady.store(false, std::memory_order_release);
+}
+
+bool FreezeFrameRecorder::getFrame(DTCCode code, FreezeFrame& out) const {
+    std::lock_guard<std::mutex> lock(partitionMutex);
+
+    const SlotHeader* best = nullptr;
+    for (size_t s = 0; s < slotCount; s++) {
+        if (!isValid(s) || slotHeader(s)->code != code) continue;
+        if (!best || slotHeader(s)->sequence > best->sequence) best = slotHeader(s);
+    }
+    if (!best) return false;
+
+    out.code = best->code;
+    out.sequence = best->sequence;
+    out.triggerTick = best->triggerTick;
+    out.samplePeriodMs = best->samplePeriodMs;
+    out.preSamples = best->preSamples;
+    std::memcpy(static_cast<void*>(out.samples.data()), best + 1, sizeof(ECUData) * best->sampleCount);
+    return true;
+}
+
+size_t FreezeFrameRecorder::getStoredCount() const {
+    std::lock_guard<std::mutex> lock(partitionMutex);
+    size_t count = 0;
+    for (size_t s = 0; s < slotCount; s++) {
+        if (isValid(s)) count++;
+    }
+    return count;
+}
@@ -0,0 +1,93 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <cstdint>
+#include <cstddef>
+#include "DTC.h"
+#include "../ECUState.h"
+#include "../memory/FlashMemory.h"
+
+// A window of engine snapshots around the moment a DTC was set
+struct FreezeFrame {
+    static constexpr size_t PreSamples = 127;   // Up to and including the trigger tick
+    static constexpr size_t PostSamples = 64;   // After it
+    static constexpr size_t Samples = PreSamples + PostSamples;
+
+    DTCCode code = 0;
+    uint32_t sequence = 0;          // Order in which frames were stored
+    uint64_t triggerTick = 0;       // Samples recorded up to and including the trigger tick
+    uint16_t samplePeriodMs = 0;
+    uint16_t preSamples = 0;        // Fewer than PreSamples if the fault hit right after startup
+
+    // Oldest first; samples[preSamples - 1] is the trigger tick
+    std::array<ECUData, Samples> samples;
+};
+
+// Keeps the last HistorySamples engine snapshots in a preallocated ring and
+// freezes a pre/post-trigger window when a DTC is set.
+//
+//   record()  physics task, every tick: one 64-byte copy, no allocation
+//   trigger() DTCManager, when a fault goes active (any thread, lock-free)
+//   poll()    housekeeping task: writes finished frames to the "freeze"
+//             partition of the flash image
+//
+// One frame is captured at a time; a trigger that arrives while a capture is
+// in progress waits for it, and further ones are counted as missed.
+class FreezeFrameRecorder {
+public:
+    static constexpr size_t HistorySamples = 256;
+    static_assert(HistorySamples >= FreezeFrame::Samples, "History must cover the whole window");
+
+    FreezeFrameRecorder(FlashMemory& flash, uint16_t samplePeriodMs);
+
+    void record(const ECUData& sample);
+    void trigger(DTCCode code);
+    void poll();
+
+    // Latest stored frame for a code
+    bool getFrame(DTCCode code, FreezeFrame& out) const;
+
+    size_t getStoredCount() const;
+    uint64_t getMissedTriggers() const { return missedTriggers.load(std::memory_order_relaxed); }
+
+private:
+    // On flash each frame takes a fixed slot: this header, then the samples
+    struct SlotHeader {
+        uint32_t magic;
+        uint32_t sequence;
+        uint64_t triggerTick;
+        uint16_t code;
+        uint16_t samplePeriodMs;
+        uint16_t preSamples;
+        uint16_t sampleCount;
+        uint8_t reserved[36];
+        uint32_t crc;           // CRC-32 of the header above and the samples
+    };
+    static constexpr size_t SlotSize = sizeof(SlotHeader) + sizeof(ECUData) * FreezeFrame::Samples;
+
+    static constexpr uint32_t NoTrigger = 0xFFFFFFFF;
+
+    const SlotHeader* slotHeader(size_t slot) const;
+    bool isValid(size_t slot) const;
+
+    FlashMemory& flash;
+    uint8_t* partition;
+    size_t slotCount;
+    size_t nextSlot = 0;
+    uint32_t nextSequence = 0;
+    mutable std::mutex partitionMutex;      // poll() vs getFrame()
+
+    // Physics task only
+    std::array<ECUData, HistorySamples> history;
+    uint64_t head = 0;                      // Samples recorded so far
+    bool capturing = false;
+    uint64_t triggerHead = 0;
+
+    std::atomic<uint32_t> pendingTrigger{NoTrigger};
+    std::atomic<uint64_t> missedTriggers{0};
+
+    // Handed from record() to poll() when the post-trigger window is complete
+    FreezeFrame captured;
+    std::atomic<bool> capturedReady{false};
+};
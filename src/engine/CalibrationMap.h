@@ -0,0 +1,169 @@
+#pragma once
+#include <array>
+#include <algorithm>
+#include <cstddef>
+
+// Calibration tables as found in ECU software: a 1D curve y = f(x) and a 2D
+// map z = f(x, y), each over strictly increasing breakpoint axes, with linear
+// (bilinear) interpolation between breakpoints and clamping outside them.
+//
+// Lookups remember the cell they last landed in. Inputs such as RPM and load
+// move slowly from one call to the next, so the next lookup almost always
+// hits the same or a neighbouring cell and costs O(1) instead of a binary
+// search. The batch overloads split a lookup into a search pass and an
+// interpolation pass; the second has no branches and vectorizes.
+
+// Where an input falls on an axis: between breakpoints index and index + 1,
+// `frac` of the way along (0..1)
+struct AxisPosition {
+    size_t index;
+    float frac;
+};
+
+template <size_t N>
+class Axis {
+    static_assert(N >= 2, "An axis needs at least two breakpoints");
+
+public:
+    constexpr Axis(const std::array<float, N>& breakpoints) : points(breakpoints) {}
+
+    constexpr size_t size() const { return N; }
+    constexpr float operator[](size_t i) const { return points[i]; }
+
+    // `hint` is the cell of the previous lookup; it is updated
+    AxisPosition locate(float x, size_t& hint) const {
+        if (x <= points[0]) return { 0, 0.0f };
+        if (x >= points[N - 1]) return { N - 2, 1.0f };
+
+        size_t i = hint < N - 1 ? hint : N - 2;
+        if (x < points[i]) {
+            // Just below the last cell?
+            if (i > 0 && x >= points[i - 1]) i--;
+            else i = search(x);
+        } else if (x >= points[i + 1]) {
+            // Just above it?
+            if (i + 2 < N && x < points[i + 2]) i++;
+            else i = search(x);
+        }
+
+        hint = i;
+        return { i, (x - points[i]) / (points[i + 1] - points[i]) };
+    }
+
+private:
+    // Cell containing x, for points[0] < x < points[N - 1]
+    size_t search(float x) const {
+        return static_cast<size_t>(std::upper_bound(points.begin(), points.end(), x) - points.begin()) - 1;
+    }
+
+    std::array<float, N> points;
+};
+
+// y = f(x)
+template <size_t N>
+class Curve {
+public:
+    constexpr Curve(const std::array<float, N>& breakpoints, const std::array<float, N>& values)
+        : axis(breakpoints), values(values) {}
+
+    float lookup(float x) const { return lookup(x, hint); }
+
+    // With a caller-owned hint, for sharing one curve between threads
+    float lookup(float x, size_t& cellHint) const {
+        AxisPosition p = axis.locate(x, cellHint);
+        return values[p.index] + p.frac * (values[p.index + 1] - values[p.index]);
+    }
+
+    // out[i] = f(x[i])
+    void lookup(const float* x, float* out, size_t count) const {
+        constexpr size_t Block = 64;
+        size_t idx[Block];
+        float frac[Block];
+
+        for (size_t base = 0; base < count; base += Block) {
+            size_t n = std::min(Block, count - base);
+            for (size_t i = 0; i < n; i++) {
+                AxisPosition p = axis.locate(x[base + i], hint);
+                idx[i] = p.index;
+                frac[i] = p.frac;
+            }
+            for (size_t i = 0; i < n; i++) {
+                float y0 = values[idx[i]];
+                float y1 = values[idx[i] + 1];
+                out[base + i] = y0 + frac[i] * (y1 - y0);
+            }
+        }
+    }
+
+    const Axis<N>& getAxis() const { return axis; }
+    float& at(size_t i) { return values[i]; }      // Tuning access
+    float at(size_t i) const { return values[i]; }
+
+private:
+    Axis<N> axis;
+    std::array<float, N> values;
+    mutable size_t hint = 0;
+};
+
+// z = f(x, y). Values are stored row by row: one row of NX values per y breakpoint.
+template <size_t NX, size_t NY>
+class Map {
+public:
+    constexpr Map(const std::array<float, NX>& xBreakpoints, const std::array<float, NY>& yBreakpoints,
+                  const std::array<float, NX * NY>& values)
+        : xAxis(xBreakpoints), yAxis(yBreakpoints), values(values) {}
+
+    float lookup(float x, float y) const { return lookup(x, y, xHint, yHint); }
+
+    // With caller-owned hints, for sharing one map between threads
+    float lookup(float x, float y, size_t& xCellHint, size_t& yCellHint) const {
+        AxisPosition px = xAxis.locate(x, xCellHint);
+        AxisPosition py = yAxis.locate(y, yCellHint);
+        return interpolate(py.index * NX + px.index, px.frac, py.frac);
+    }
+
+    // out[i] = f(x[i], y[i])
+    void lookup(const float* x, const float* y, float* out, size_t count) const {
+        constexpr size_t Block = 64;
+        size_t cell[Block];
+        float fx[Block];
+        float fy[Block];
+
+        for (size_t base = 0; base < count; base += Block) {
+            size_t n = std::min(Block, count - base);
+            for (size_t i = 0; i < n; i++) {
+                AxisPosition px = xAxis.locate(x[base + i], xHint);
+                AxisPosition py = yAxis.locate(y[base + i], yHint);
+                cell[i] = py.index * NX + px.index;
+                fx[i] = px.frac;
+                fy[i] = py.frac;
+            }
+            for (size_t i = 0; i < n; i++) {
+                out[base + i] = interpolate(cell[i], fx[i], fy[i]);
+            }
+        }
+    }
+
+    const Axis<NX>& getXAxis() const { return xAxis; }
+    const Axis<NY>& getYAxis() const { return yAxis; }
+    float& at(size_t ix, size_t iy) { return values[iy * NX + ix]; }      // Tuning access
+    float at(size_t ix, size_t iy) const { return values[iy * NX + ix]; }
+
+private:
+    // Bilinear blend of the four corners of the cell whose low corner is values[cell]
+    float interpolate(size_t cell, float fx, float fy) const {
+        float z00 = values[cell];
+        float z10 = values[cell + 1];
+        float z01 = values[cell + NX];
+        float z11 = values[cell + NX + 1];
+        float low = z00 + fx * (z10 - z00);
+        float high = z01 + fx * (z11 - z01);
+        return low + fy * (high - low);
+    }
+
+    Axis<NX> xAxis;
+    Axis<NY> yAxis;
+    std::array<float, NX * NY> values;
+    mutable size_t xHint = 0;
+    mutable size_t yHint = 0;
+};
@@ -0,0 +1,121 @@
+#include "CrankEngine.h"
+#include <cmath>
+#include <algorithm>
+
+static const float CycleDegrees = 720.0f;
+static const float ExhaustOpenAngle = 140.0f;   // 40 degrees before BDC
+static const float IntakeOpenAngle = 350.0f;    // 10 degrees before TDC (overlap)
+static const float IntakeCloseAngle = 580.0f;   // 40 degrees after BDC
+
+// Firing order 1-3-4-2: where each cylinder's cycle starts on the crank
+static const float CylinderOffset[CrankEngine::Cylinders] = { 0.0f, 540.0f, 180.0f, 360.0f };
+
+// RPM -> crank degrees per second
+static const double DegreesPerRev = 360.0 / 60.0;
+
+CrankEngine::CrankEngine() {
+    for (uint8_t c = 0; c < Cylinders; c++) {
+        schedule(c, EventType::ExhaustOpen, ExhaustOpenAngle);
+        schedule(c, EventType::IntakeOpen, IntakeOpenAngle);
+        schedule(c, EventType::IntakeClose, IntakeCloseAngle);
+        schedule(c, EventType::InjectionStart, injectionAngle);
+        schedule(c, EventType::Spark, CycleDegrees - sparkAdvance);
+    }
+}
+
+void CrankEngine::setInjection(float pulse, float startAngle) {
+    pulseMs = std::max(0.0f, pulse);
+    injectionAngle = std::fmod(std::fmod(startAngle, CycleDegrees) + CycleDegrees, CycleDegrees);
+}
+
+void CrankEngine::setSparkAdvance(float degreesBTDC) {
+    sparkAdvance = std::min(std::max(degreesBTDC, 0.0f), 90.0f);
+}
+
+// First occurrence of cycleAngle in the given cylinder's cycle (at startup)
+void CrankEngine::schedule(uint8_t cylinder, EventType type, float cycleAngle) {
+    double angle = CylinderOffset[cylinder] + cycleAngle;
+    while (angle - CycleDegrees >= crankAngle) angle -= CycleDegrees;
+    events.push({ angle, cycleAngle, type, cylinder });
+}
+
+// Same event in the cylinder's next cycle, possibly at a new angle: exactly
+// one per cycle even when SOI or spark advance moves
+void CrankEngine::reschedule(const Event& e, float cycleAngle) {
+    double cycleStart = e.angle - e.cycleAngle;
+    events.push({ cycleStart + CycleDegrees + cycleAngle, cycleAngle, e.type, e.cylinder });
+}
+
+void CrankEngine::update(float throttlePct, float loadTorque, float dtSeconds) {
+    double remaining = dtSeconds;
+
+    while (remaining > 0.0) {
+        double degPerSec = physics.getRPM() * DegreesPerRev;
+        if (degPerSec <= 0.0) {
+            // Stalled: nothing turns, only the physics can restart it
+            physics.advance(throttlePct, loadTorque, static_cast<float>(remaining));
+            return;
+        }
+
+        const Event next = events.top();
+        double toEvent = (next.angle - crankAngle) / degPerSec;
+        if (toEvent > remaining) {
+            crankAngle += degPerSec * remaining;
+            physics.advance(throttlePct, loadTorque, static_cast<float>(remaining));
+            return;
+        }
+
+        // Run the physics up to the event, then fire it
+        if (toEvent > 0.0) physics.advance(throttlePct, loadTorque, static_cast<float>(toEvent));
+        crankAngle = next.angle;
+        remaining -= toEvent;
+
+        events.pop();
+        fire(next);
+    }
+}
+
+void CrankEngine::fire(const Event& e) {
+    CylinderStats& cyl = stats[e.cylinder];
+    eventCount++;
+
+    switch (e.type) {
+    case EventType::ExhaustOpen:
+        reschedule(e, ExhaustOpenAngle);
+        break;
+    case EventType::IntakeOpen:
+        cyl.intakeOpen = true;
+        if (cyl.injecting) cyl.openValveInjections++;  // Pulse runs into the open valve
+        reschedule(e, IntakeOpenAngle);
+        break;
+    case EventType::IntakeClose:
+        cyl.intakeOpen = false;
+        reschedule(e, IntakeCloseAngle);
+        break;
+    case EventType::InjectionStart:
+        if (pulseMs > 0.0f && !cyl.injecting) {
+            // Pulse width in crank degrees at the current speed
+            float width = static_cast<float>(pulseMs / 1000.0 * getRPM() * DegreesPerRev);
+            width = std::min(width, CycleDegrees - 1.0f);
+
+            cyl.injections++;
+            if (cyl.intakeOpen) cyl.openValveInjections++;
+            cyl.injecting = true;
+            cyl.lastPulseMs = pulseMs;
+            cyl.lastInjectionStart = e.cycleAngle;
+            cyl.lastInjectionEnd = std::fmod(e.cycleAngle + width, CycleDegrees);
+            events.push({ e.angle + width, cyl.lastInjectionEnd, EventType::InjectionEnd, e.cylinder });
+        }
+        reschedule(e, injectionAngle);   // Picks up a new SOI
+        break;
+    case EventType::InjectionEnd:
+        cyl.injecting = false;
+        break;
+    case EventType::Spark:
+        cyl.sparks++;
+        reschedule(e, CycleDegrees - sparkAdvance);
+        break;
+    }
+
+    if (eventHook) eventHook(e);
+}
@@ -0,0 +1,90 @@
+#pragma once
+#include <array>
+#include <functional>
+#include <cstdint>
+#include "EnginePhysics.h"
+#include "../common/FixedHeap.h"
+
+// Crank-angle-resolved view of a 4-cylinder, 4-stroke engine.
+//
+// EnginePhysics still decides how fast the crank turns; on top of it every
+// cylinder gets its valve, injection and spark events at their crank angles
+// (720 degrees per cycle, firing order 1-3-4-2). update() walks from one event
+// to the next, advancing the physics exactly up to each event, so injection
+// and spark timing from the ECU land on the cylinder they are meant for.
+// getRPM() is the same aggregate speed as before.
+//
+// Angles within a cylinder's cycle are measured from its firing TDC:
+//   0     firing TDC       140  exhaust valve opens   350  intake valve opens
+//   580   intake closes    720 - advance  spark       SOI  injection start
+//
+// Events live in a fixed-capacity heap, so a step never allocates, even at
+// 7000 RPM (about 1400 events per second).
+class CrankEngine {
+public:
+    static constexpr int Cylinders = 4;
+
+    enum class EventType : uint8_t { ExhaustOpen, IntakeOpen, IntakeClose, InjectionStart, InjectionEnd, Spark };
+
+    struct Event {
+        double angle;           // Absolute crank angle, degrees since start
+        float cycleAngle;       // Within the cylinder's 720-degree cycle
+        EventType type;
+        uint8_t cylinder;       // 0-based, in physical order (cylinder 1 = 0)
+    };
+
+    struct CylinderStats {
+        uint64_t injections = 0;
+        uint64_t sparks = 0;
+        uint64_t openValveInjections = 0;   // Pulses that overlapped an open intake valve
+        float lastInjectionStart = 0.0f;    // Cycle angles of the last pulse
+        float lastInjectionEnd = 0.0f;
+        float lastPulseMs = 0.0f;
+        bool intakeOpen = false;
+        bool injecting = false;
+    };
+
+    CrankEngine();
+
+    // Same inputs and meaning as EnginePhysics::update
+    void update(float throttlePct, float loadTorque, float dtSeconds);
+
+    float getRPM() const { return physics.getRPM(); }
+    void setRPM(float newRPM) { physics.setRPM(newRPM); }
+
+    // Pulse width from FuelControl and its start angle (SOI, cycle degrees).
+    // Applies from each cylinder's next injection.
+    void setInjection(float pulseMs, float startAngle);
+    void setSparkAdvance(float degreesBTDC);
+
+    // Called for every event as it happens (set during setup; must not block)
+    void setEventHook(std::function<void(const Event&)> hook) { eventHook = std::move(hook); }
+
+    double getCrankAngle() const { return crankAngle; }
+    uint64_t getEventCount() const { return eventCount; }
+    const CylinderStats& getCylinderStats(int cylinder) const { return stats[cylinder]; }
+    EnginePhysics& getPhysics() { return physics; }
+
+private:
+    struct Later {
+        bool operator()(const Event& a, const Event& b) const { return a.angle < b.angle; }
+    };
+
+    // 5 periodic events per cylinder plus one pending injection end each
+    static constexpr size_t QueueCapacity = 32;
+
+    void schedule(uint8_t cylinder, EventType type, float cycleAngle);
+    void reschedule(const Event& e, float cycleAngle);
+    void fire(const Event& e);
+
+    EnginePhysics physics;
+    FixedHeap<Event, QueueCapacity, Later> events;
+    std::array<CylinderStats, Cylinders> stats{};
+    std::function<void(const Event&)> eventHook;
+
+    double crankAngle = 0.0;
+    uint64_t eventCount = 0;
+    float pulseMs = 0.0f;
+    float injectionAngle = 300.0f;   // Closed-valve injection, before the intake opens
+    float sparkAdvance = 10.0f;
+};
@@ -0,0 +1,118 @@
+#include "EngineFleet.h"
+#include <thread>
+#include <algorithm>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define FLEET_AVX2 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define FLEET_SSE2 1
+#endif
+
+// Model constants, as in EnginePhysics
+static const float TorquePerThrottle = 2.5f;
+static const float FrictionPerRPM = 0.02f;
+static const float RadToRPM = 9.549f;
+static const float Redline = 7000.0f;
+
+EngineFleet::EngineFleet(size_t count)
+    : rpm(count, 800.0f), throttle(count, 0.0f), load(count, 0.0f), friction(count, 10.0f),
+      inertia(count, 0.2f) {}
+
+const char* EngineFleet::getSimdPath() {
+#if defined(FLEET_AVX2)
+    return "AVX2";
+#elif defined(FLEET_SSE2)
+    return "SSE2";
+#else
+    return "scalar";
+#endif
+}
+
+void EngineFleet::step(float dtSeconds) {
+    stepRange(0, size(), dtSeconds);
+}
+
+void EngineFleet::advance(size_t steps, float dtSeconds, unsigned threads) {
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+
+    // Slices of whole cache lines, and not so small that threads cost more than they save
+    const size_t minSlice = 1024;
+    size_t count = size();
+    size_t workers = std::min<size_t>(threads, std::max<size_t>(1, count / minSlice));
+    size_t slice = ((count + workers - 1) / workers + 15) & ~size_t(15);
+
+    auto run = [this, steps, dtSeconds](size_t begin, size_t end) {
+        for (size_t s = 0; s < steps; s++) stepRange(begin, end, dtSeconds);
+    };
+
+    std::vector<std::thread> pool;
+    for (size_t begin = slice; begin < count; begin += slice) {
+        pool.emplace_back(run, begin, std::min(count, begin + slice));
+    }
+    run(0, std::min(count, slice)); // First slice on the calling thread
+    for (auto& t : pool) t.join();
+}
+
+void EngineFleet::stepRange(size_t begin, size_t end, float dtSeconds) {
+    float* r = rpm.data();
+    const float* thr = throttle.data();
+    const float* ld = load.data();
+    const float* fr = friction.data();
+    const float* in = inertia.data();
+    size_t i = begin;
+
+#if defined(FLEET_AVX2)
+    const __m256 torquePerThrottle = _mm256_set1_ps(TorquePerThrottle);
+    const __m256 frictionPerRPM = _mm256_set1_ps(FrictionPerRPM);
+    const __m256 dt = _mm256_set1_ps(dtSeconds);
+    const __m256 radToRPM = _mm256_set1_ps(RadToRPM);
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 redline = _mm256_set1_ps(Redline);
+
+    for (; i + 8 <= end; i += 8) {
+        __m256 speed = _mm256_loadu_ps(r + i);
+        __m256 combustion = _mm256_mul_ps(_mm256_loadu_ps(thr + i), torquePerThrottle);
+        __m256 frictionTorque = _mm256_add_ps(_mm256_loadu_ps(fr + i), _mm256_mul_ps(speed, frictionPerRPM));
+        __m256 net = _mm256_sub_ps(_mm256_sub_ps(combustion, frictionTorque), _mm256_loadu_ps(ld + i));
+        __m256 accel = _mm256_div_ps(net, _mm256_loadu_ps(in + i));
+        __m256 change = _mm256_mul_ps(_mm256_mul_ps(accel, dt), radToRPM);
+        speed = _mm256_add_ps(speed, change);
+        speed = _mm256_min_ps(_mm256_max_ps(speed, zero), redline);
+        _mm256_storeu_ps(r + i, speed);
+    }
+#elif defined(FLEET_SSE2)
+    const __m128 torquePerThrottle = _mm_set1_ps(TorquePerThrottle);
+    const __m128 frictionPerRPM = _mm_set1_ps(FrictionPerRPM);
+    const __m128 dt = _mm_set1_ps(dtSeconds);
+    const __m128 radToRPM = _mm_set1_ps(RadToRPM);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 redline = _mm_set1_ps(Redline);
+
+    for (; i + 4 <= end; i += 4) {
+        __m128 speed = _mm_loadu_ps(r + i);
+        __m128 combustion = _mm_mul_ps(_mm_loadu_ps(thr + i), torquePerThrottle);
+        __m128 frictionTorque = _mm_add_ps(_mm_loadu_ps(fr + i), _mm_mul_ps(speed, frictionPerRPM));
+        __m128 net = _mm_sub_ps(_mm_sub_ps(combustion, frictionTorque), _mm_loadu_ps(ld + i));
+        __m128 accel = _mm_div_ps(net, _mm_loadu_ps(in + i));
+        __m128 change = _mm_mul_ps(_mm_mul_ps(accel, dt), radToRPM);
+        speed = _mm_add_ps(speed, change);
+        speed = _mm_min_ps(_mm_max_ps(speed, zero), redline);
+        _mm_storeu_ps(r + i, speed);
+    }
+#endif
+
+    // Scalar tail (or everything, without SIMD)
+    for (; i < end; i++) {
+        float combustionTorque = thr[i] * TorquePerThrottle;
+        float frictionTorque = fr[i] + (r[i] * FrictionPerRPM);
+        float netTorque = combustionTorque - frictionTorque - ld[i];
+        float angularAccel = netTorque / in[i];
+        float rpmChange = (angularAccel * dtSeconds) * RadToRPM;
+
+        r[i] += rpmChange;
+        if (r[i] < 0) r[i] = 0;
+        if (r[i] > Redline) r[i] = Redline;
+    }
+}
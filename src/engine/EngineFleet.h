@@ -0,0 +1,57 @@
+#pragma once
+#include <vector>
+#include <cstddef>
+
+// Many independent engines with the same model as EnginePhysics, stored as a
+// structure of arrays (one contiguous array per quantity) so a step advances
+// 4 (SSE) or 8 (AVX2) engines per instruction.
+//
+// Each engine follows exactly the arithmetic of EnginePhysics::update, in the
+// same order, so a fleet engine tracks a scalar EnginePhysics fed the same
+// inputs to within float rounding.
+//
+// The SIMD path is picked at compile time: AVX2 when the build enables it
+// (cmake -DECU_ENABLE_AVX2=ON), otherwise SSE2 on x86, otherwise plain scalar
+// code. getSimdPath() says which one a binary got.
+class EngineFleet {
+public:
+    explicit EngineFleet(size_t count);
+
+    size_t size() const { return rpm.size(); }
+
+    // Per-engine state and inputs, same defaults as EnginePhysics
+    float getRPM(size_t i) const { return rpm[i]; }
+    void setRPM(size_t i, float value) { rpm[i] = value; }
+    void setThrottle(size_t i, float pct) { throttle[i] = pct; }
+    void setLoad(size_t i, float torque) { load[i] = torque; }
+    void setFriction(size_t i, float torque) { friction[i] = torque; }
+    void setInertia(size_t i, float kgm2) { inertia[i] = kgm2; }
+
+    // Whole arrays, for bulk setup and readout
+    float* rpmData() { return rpm.data(); }
+    float* throttleData() { return throttle.data(); }
+    float* loadData() { return load.data(); }
+    float* frictionData() { return friction.data(); }
+    float* inertiaData() { return inertia.data(); }
+    const float* rpmData() const { return rpm.data(); }
+
+    // Advance every engine by one step, on the calling thread
+    void step(float dtSeconds);
+
+    // Advance every engine by `steps` steps, inputs held constant. Engines are
+    // independent, so each thread takes a contiguous slice and runs all the
+    // steps on it without synchronizing. threads = 0: one per core.
+    void advance(size_t steps, float dtSeconds, unsigned threads = 0);
+
+    // "AVX2", "SSE2" or "scalar"
+    static const char* getSimdPath();
+
+private:
+    void stepRange(size_t begin, size_t end, float dtSeconds);
+
+    std::vector<float> rpm;
+    std::vector<float> throttle;
+    std::vector<float> load;
+    std::vector<float> friction;
+    std::vector<float> inertia;
+};
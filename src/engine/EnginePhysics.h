@@ -2,13 +2,34 @@
 
 #pragma once
 #include <algorithm>
+#include <cmath>
 
 class EnginePhysics {
 public:
-    EnginePhysics() : rpm(800.0f), internalFriction(10.0f) {}
+    // How update()/advance() integrate dRPM/dt:
+    //   Euler              explicit Euler, the original model (default)
+    //   SemiImplicitEuler  friction (the only term that depends on RPM) taken at
+    //                      the end of the step: stable at any step size
+    //   RK4                classic 4th-order Runge-Kutta
+    //   RK45               Dormand-Prince 5(4) with error control; advance()
+    //                      picks its own sub-steps to stay within the tolerance
+    enum class Integrator { Euler, SemiImplicitEuler, RK4, RK45 };
 
-    // Run this every cycle to update RPM based on physics
+    EnginePhysics() : rpm(800.0f), internalFriction(10.0f), inertia(0.2f) {}
+
+    void setIntegrator(Integrator method) { integrator = method; }
+    Integrator getIntegrator() const { return integrator; }
+
+    // RK45 local error target, in RPM
+    void setTolerance(float rpmError) { tolerance = rpmError; }
+
+    // Run this every cycle to update RPM based on physics (one step of dtSeconds)
     void update(float throttlePct, float loadTorque, float dtSeconds) {
+        if (integrator != Integrator::Euler) {
+            step(throttlePct, loadTorque, dtSeconds);
+            return;
+        }
+
         // 1. Calculate Torque produced by combustion (simplified model)
         // More throttle = More torque. 
         // Peak torque curve usually modeled here, but we use linear for now.
@@ -22,7 +43,7 @@ public:
 
         // 4. Newton's 2nd Law for Rotation: Torque = Inertia * AngularAccel
         // Inertia (flywheel + crank) roughly 0.2 kg*m^2
-        float angularAccel = netTorque / 0.2f; 
+        float angularAccel = netTorque / inertia; 
 
         // 5. Integrate to get RPM
         // Convert rad/s^2 to RPM/s -> (accel * 60) / 2PI
@@ -35,12 +56,125 @@ public:
         if (rpm > 7000) rpm = 7000; // Rev limiter physics
     }
 
+    // Advance by one large dtSeconds, sub-stepped internally. Fixed-step
+    // integrators take equal steps of at most maxStepSeconds; RK45 adapts its
+    // steps to the tolerance and ignores maxStepSeconds. A maxStepSeconds
+    // below MinStep (zero, negative or NaN) is clamped to MinStep.
+    void advance(float throttlePct, float loadTorque, float dtSeconds, float maxStepSeconds = 0.01f) {
+        if (integrator == Integrator::RK45) {
+            advanceAdaptive(throttlePct, loadTorque, dtSeconds);
+            return;
+        }
+        if (!(maxStepSeconds >= MinStep)) maxStepSeconds = MinStep;
+        int steps = std::max(1, static_cast<int>(std::ceil(dtSeconds / maxStepSeconds)));
+        float h = dtSeconds / steps;
+        for (int i = 0; i < steps; i++) update(throttlePct, loadTorque, h);
+    }
+
+    // dRPM/dt at a given speed, same terms as update()
+    float derivative(float atRPM, float throttlePct, float loadTorque) const {
+        float combustionTorque = throttlePct * 2.5f;
+        float frictionTorque = internalFriction + (atRPM * 0.02f);
+        float netTorque = combustionTorque - frictionTorque - loadTorque;
+        return (netTorque / inertia) * 9.549f;
+    }
+
     float getRPM() const { return rpm; }
     void setRPM(float newRPM) { rpm = newRPM; } // For starter motor
 
+    // Model constants, for calibration sweeps
+    void setFriction(float torque) { internalFriction = torque; }
+    void setInertia(float kgm2) { inertia = kgm2; }
+
 private:
+    // One step of the selected (non-Euler) integrator
+    void step(float throttlePct, float loadTorque, float h) {
+        switch (integrator) {
+        case Integrator::SemiImplicitEuler: {
+            // rpm' = a - b * rpm with the b * rpm term implicit:
+            // rpm1 = (rpm0 + h * a) / (1 + h * b)
+            float b = 0.02f / inertia * 9.549f;
+            float a = derivative(0.0f, throttlePct, loadTorque);
+            rpm = (rpm + h * a) / (1.0f + h * b);
+            break;
+        }
+        case Integrator::RK4: {
+            float k1 = derivative(rpm, throttlePct, loadTorque);
+            float k2 = derivative(rpm + 0.5f * h * k1, throttlePct, loadTorque);
+            float k3 = derivative(rpm + 0.5f * h * k2, throttlePct, loadTorque);
+            float k4 = derivative(rpm + h * k3, throttlePct, loadTorque);
+            rpm += h / 6.0f * (k1 + 2.0f * k2 + 2.0f * k3 + k4);
+            break;
+        }
+        case Integrator::RK45: {
+            float error;
+            rpm = dormandPrince(throttlePct, loadTorque, h, error);
+            break;
+        }
+        case Integrator::Euler:
+            break;
+        }
+        clamp();
+    }
+
+    // One Dormand-Prince step from the current rpm: returns the 5th-order
+    // result and the difference to the embedded 4th-order one
+    float dormandPrince(float throttlePct, float loadTorque, float h, float& error) const {
+        auto f = [&](float r) { return derivative(r, throttlePct, loadTorque); };
+        float y = rpm;
+        float k1 = f(y);
+        float k2 = f(y + h * (1.0f / 5 * k1));
+        float k3 = f(y + h * (3.0f / 40 * k1 + 9.0f / 40 * k2));
+        float k4 = f(y + h * (44.0f / 45 * k1 - 56.0f / 15 * k2 + 32.0f / 9 * k3));
+        float k5 = f(y + h * (19372.0f / 6561 * k1 - 25360.0f / 2187 * k2 + 64448.0f / 6561 * k3 - 212.0f / 729 * k4));
+        float k6 = f(y + h * (9017.0f / 3168 * k1 - 355.0f / 33 * k2 + 46732.0f / 5247 * k3 + 49.0f / 176 * k4 - 5103.0f / 18656 * k5));
+        float y5 = y + h * (35.0f / 384 * k1 + 500.0f / 1113 * k3 + 125.0f / 192 * k4 - 2187.0f / 6784 * k5 + 11.0f / 84 * k6);
+        float k7 = f(y5);
+        float y4 = y + h * (5179.0f / 57600 * k1 + 7571.0f / 16695 * k3 + 393.0f / 640 * k4
+                            - 92097.0f / 339200 * k5 + 187.0f / 2100 * k6 + 1.0f / 40 * k7);
+        error = std::fabs(y5 - y4);
+        return y5;
+    }
+
+    void advanceAdaptive(float throttlePct, float loadTorque, float dtSeconds) {
+        float remaining = dtSeconds;
+        float h = adaptiveStep;
+        while (remaining > 0.0f) {
+            float trial = std::min(h, remaining);
+            float error;
+            float next = dormandPrince(throttlePct, loadTorque, trial, error);
+
+            // Standard step-size controller: grow or shrink by (tol/err)^(1/5)
+            float scale = (error > 0.0f) ? 0.9f * std::pow(tolerance / error, 0.2f) : 5.0f;
+            scale = std::min(5.0f, std::max(0.2f, scale));
+
+            bool accepted = error <= tolerance || trial <= MinStep;
+            if (accepted) {
+                rpm = next;
+                clamp();
+                remaining -= trial;
+            }
+            // A step only cut short by the end of the interval says nothing
+            // about the right step size, so don't let it shrink h
+            if (!accepted || trial == h) h = std::max(MinStep, h * scale);
+        }
+        adaptiveStep = h; // Carry the step size into the next call
+    }
+
+    void clamp() {
+        if (rpm < 0) rpm = 0;
+        if (rpm > 7000) rpm = 7000; // Rev limiter physics
+    }
+
+    static constexpr float MinStep = 1e-5f;
+
     float rpm;
     float internalFriction;
+    float inertia;
+
+    Integrator integrator = Integrator::Euler;
+    float tolerance = 0.05f;
+    float adaptiveStep = 0.01f;
 };
 
 // Simple 1D Engine Physics Model
@@ -50,6 +184,6 @@ private:
 // Assumptions/Simplifications:
 // - Linear torque curve with throttle
 // - Constant internal friction
-// - Fixed rotational inertia
+// - Constant rotational inertia per instance (setInertia, default 0.2 kg*m^2)
 // - No transient effects like turbo lag or variable valve timing   
 // This is sufficient for a basic ECU simulator without complex engine dynamics.
@@ -2,11 +2,41 @@
 #include <cmath>
 #include <algorithm>
 
+// Default calibration. The VE values are the old linear model sampled at the
+// breakpoints:  0.75 + 0.15 * (1 - |rpm - 4000| / 4000) + 0.10 * throttle / 100
+// It is linear in throttle and has its only kink at 4000 RPM (a breakpoint),
+// so the interpolated map matches the old formula everywhere on the axes.
+static constexpr std::array<float, 16> VERpmAxis = {
+    0, 500, 1000, 1500, 2000, 2500, 3000, 3500, 4000, 4500, 5000, 5500, 6000, 6500, 7000, 7500
+};
+static constexpr std::array<float, 16> VEThrottleAxis = {
+    0, 5, 10, 15, 20, 25, 30, 40, 50, 60, 70, 80, 85, 90, 95, 100
+};
+
+static constexpr std::array<float, 16 * 16> defaultVE() {
+    std::array<float, 16 * 16> ve{};
+    for (size_t t = 0; t < 16; t++) {
+        for (size_t r = 0; r < 16; r++) {
+            float distance = VERpmAxis[r] > 4000.0f ? VERpmAxis[r] - 4000.0f : 4000.0f - VERpmAxis[r];
+            float rpmFactor = 1.0f - distance / 4000.0f; // Peak at 4000
+            ve[t * 16 + r] = 0.75f + (0.15f * rpmFactor) + (0.10f * (VEThrottleAxis[t] / 100.0f));
+        }
+    }
+    return ve;
+}
+
+// Stoichiometric (gasoline) up to ~80% throttle, then power enrichment (12.5:1)
+// for power/cooling. The step is spread over 79-81% so the mixture doesn't jump.
+static constexpr std::array<float, 4> AFRThrottleAxis = { 0.0f, 79.0f, 81.0f, 100.0f };
+static constexpr std::array<float, 4> AFRTargets = { 14.7f, 14.7f, 12.5f, 12.5f };
+
+FuelControl::FuelControl()
+    : veMap(VERpmAxis, VEThrottleAxis, defaultVE()),
+      afrCurve(AFRThrottleAxis, AFRTargets) {}
+
 float FuelControl::getVE(int rpm, float throttle) {
-    // Simplified VE Table: Engines breathe best at mid-RPM and high throttle
-    // Real ECUs use a 3D lookup table here.
-    float rpmFactor = 1.0f - std::abs(rpm - 4000) / 4000.0f; // Peak at 4000
-    return 0.75f + (0.15f * rpmFactor) + (0.10f * (throttle / 100.0f));
+    // 3D lookup table, as on a real ECU
+    return veMap.lookup(static_cast<float>(rpm), throttle);
 }
 
 float FuelControl::calculateInjectionTime(int rpm, float throttle, float intakeTemp) {
@@ -31,10 +61,8 @@ float FuelControl::calculateInjectionTime(int rpm, float throttle, float intakeT
     // (/4 because 4 cylinders, 1 intake stroke per 2 revs? simplified per cylinder)
 
     // --- 3. Target AFR Strategy ---
-    float targetAFR = 14.7f; // Stoichiometric (Gasoline)
-    
-    // Power Enrichment: If full throttle, go rich (12.5:1) for power/cooling
-    if (throttle > 80.0f) targetAFR = 12.5f;
+    // Stoichiometric, with power enrichment at full throttle (see afrCurve)
+    float targetAFR = afrCurve.lookup(throttle);
 
     // --- 4. Calculate Fuel Mass ---
     float fuelMass = airMassPerCycle / targetAFR;
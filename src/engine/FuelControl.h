@@ -17,25 +17,40 @@
 
 
 #pragma once
+#include "CalibrationMap.h"
 
 class FuelControl {
 public:
+    // Volumetric Efficiency map: RPM x throttle %
+    using VEMap = Map<16, 16>;
+    // Target air/fuel ratio over throttle %
+    using AFRCurve = Curve<4>;
+
+    FuelControl();
+
     // Returns pulse width in milliseconds
     float calculateInjectionTime(int rpm, float throttle, float intakeTemp);
 
     float getAFR() const { return currentAFR; }
 
+    // Calibration, for tuning
+    VEMap& getVEMap() { return veMap; }
+    AFRCurve& getAFRCurve() { return afrCurve; }
+
 private:
     float currentAFR = 14.7f;
     
     // Volumetric Efficiency Map (How well the cylinder fills with air)
     float getVE(int rpm, float throttle);
+
+    VEMap veMap;
+    AFRCurve afrCurve;
 };
 // Simple Fuel Control Module
 // Inputs: RPM, Throttle %, Intake Temp
 // Outputs: Fuel Pulse Width (ms)
 // Uses a basic VE map and cold enrichment
 // Assumptions/Simplifications:
-// - Constant stoichiometric AFR (14.7)
-// - Simple linear VE map
+// - Stoichiometric AFR (14.7), richer (12.5) at full throttle
+// - 16x16 VE map (default values follow a simple linear model)
 // - No transient fuel corrections (acceleration enrichment, etc.)
\ No newline at end of file
@@ -0,0 +1,62 @@
+#include "HistoryPlot.h"
+#include <algorithm>
+#include <cstdio>
+
+HistoryPlot::HistoryPlot(const char* label, const char* unit, float minValue, float maxValue, ImU32 color)
+    : label(label), unit(unit), minValue(minValue), maxValue(maxValue), color(color) {}
+
+void HistoryPlot::push(float value) {
+    latest = value;
+    history.push(value);
+}
+
+void HistoryPlot::draw(uint64_t window, float height) {
+    ImVec2 origin = ImGui::GetCursorScreenPos();
+    float width = std::max(ImGui::GetContentRegionAvail().x, 1.0f);
+    size_t columns = static_cast<size_t>(width);
+    if (mins.size() < columns) {
+        mins.resize(columns);
+        maxs.resize(columns);
+    }
+    history.envelope(window, columns, mins.data(), maxs.data());
+
+    ImDrawList* draw = ImGui::GetWindowDrawList();
+    ImVec2 corner(origin.x + width, origin.y + height);
+    draw->AddRectFilled(origin, corner, IM_COL32(25, 25, 30, 255));
+    draw->AddRect(origin, corner, IM_COL32(70, 70, 80, 255));
+
+    // Value -> y, clamped to the plot
+    float scale = (height - 2.0f) / (maxValue - minValue);
+    auto toY = [&](float v) {
+        v = std::min(std::max(v, minValue), maxValue);
+        return corner.y - 1.0f - (v - minValue) * scale;
+    };
+
+    // One stroke per column from its min to its max. Each stroke is stretched
+    // to meet the previous column's range so a fast edge stays connected.
+    bool havePrev = false;
+    float prevMin = 0.0f, prevMax = 0.0f;
+    for (size_t c = 0; c < columns; c++) {
+        if (mins[c] > maxs[c]) {
+            havePrev = false;   // No data for this column
+            continue;
+        }
+        float lo = mins[c], hi = maxs[c];
+        if (havePrev) {
+            lo = std::min(lo, prevMax);
+            hi = std::max(hi, prevMin);
+        }
+        float x = origin.x + static_cast<float>(c) + 0.5f;
+        draw->AddLine(ImVec2(x, toY(lo)), ImVec2(x, toY(hi) - 1.0f), color);
+
+        prevMin = mins[c];
+        prevMax = maxs[c];
+        havePrev = true;
+    }
+
+    char text[64];
+    std::snprintf(text, sizeof(text), "%s  %.1f %s", label, latest, unit);
+    draw->AddText(ImVec2(origin.x + 4.0f, origin.y + 2.0f), IM_COL32(220, 220, 220, 255), text);
+
+    ImGui::Dummy(ImVec2(width, height));
+}
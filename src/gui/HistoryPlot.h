@@ -0,0 +1,31 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include "imgui.h"
+#include "MinMaxHistory.h"
+
+// A scrolling trend of one signal on the dashboard: a MinMaxHistory drawn as
+// its min/max envelope, one vertical stroke per pixel column, straight onto
+// the window's ImDrawList. Drawing cost depends on the plot width, not on how
+// many samples have been pushed.
+class HistoryPlot {
+public:
+    HistoryPlot(const char* label, const char* unit, float minValue, float maxValue, ImU32 color);
+
+    void push(float value);
+
+    // Plot the last `window` samples across the available width
+    void draw(uint64_t window, float height);
+
+private:
+    const char* label;
+    const char* unit;
+    float minValue;
+    float maxValue;
+    ImU32 color;
+    float latest = 0.0f;
+
+    MinMaxHistory history;
+    std::vector<float> mins;    // Per-column scratch, grown to the widest plot seen
+    std::vector<float> maxs;
+};
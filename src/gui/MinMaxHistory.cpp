@@ -0,0 +1,101 @@
+#include "MinMaxHistory.h"
+#include <algorithm>
+#include <limits>
+
+static constexpr float Inf = std::numeric_limits<float>::infinity();
+
+MinMaxHistory::MinMaxHistory()
+    : mins(Levels * Capacity), maxs(Levels * Capacity) {
+    pending.fill({ Inf, -Inf, 0 });
+}
+
+void MinMaxHistory::push(float value) {
+    float lo = value, hi = value;
+
+    // Store at level 0 and carry up while a level completes a bucket: one
+    // store per push, plus a merge every Factor pushes, every Factor^2, ...
+    for (size_t k = 0; k < Levels; k++) {
+        size_t slot = k * Capacity + static_cast<size_t>(completed[k] % Capacity);
+        mins[slot] = lo;
+        maxs[slot] = hi;
+        completed[k]++;
+
+        if (k + 1 == Levels) break;
+        Pending& up = pending[k + 1];
+        up.min = std::min(up.min, lo);
+        up.max = std::max(up.max, hi);
+        if (++up.count < Factor) break;
+
+        lo = up.min;
+        hi = up.max;
+        up = { Inf, -Inf, 0 };
+    }
+}
+
+MinMaxHistory::Pending MinMaxHistory::partial(size_t level) const {
+    Pending p{ Inf, -Inf, 0 };
+    for (size_t k = 1; k <= level; k++) {
+        p.min = std::min(p.min, pending[k].min);
+        p.max = std::max(p.max, pending[k].max);
+        p.count += pending[k].count;
+    }
+    return p;
+}
+
+void MinMaxHistory::envelope(uint64_t window, size_t columns, float* outMin, float* outMax) const {
+    std::fill(outMin, outMin + columns, Inf);
+    std::fill(outMax, outMax + columns, -Inf);
+    if (columns == 0 || window == 0) return;
+
+    const double perColumn = static_cast<double>(window) / columns;
+
+    // Coarsest level whose buckets fit in a column, or coarser still if
+    // that level doesn't reach back far enough
+    size_t level = 0;
+    uint64_t bucketSize = 1;
+    while (level + 1 < Levels && bucketSize * Factor <= perColumn) {
+        level++;
+        bucketSize *= Factor;
+    }
+    while (level + 1 < Levels && Capacity * bucketSize < window) {
+        level++;
+        bucketSize *= Factor;
+    }
+
+    const int64_t total = static_cast<int64_t>(size());
+    const int64_t start = total - static_cast<int64_t>(window);   // First sample of the window (may be < 0)
+    const uint64_t done = completed[level];
+    const uint64_t oldest = done > Capacity ? done - Capacity : 0;
+    const Pending newest = partial(level);
+    if (done == 0 && newest.count == 0) return;
+
+    // Buckets overlapping the window, oldest first. The newest one is the
+    // incomplete bucket, if it has any samples yet.
+    uint64_t first = start > 0 ? static_cast<uint64_t>(start) / bucketSize : 0;
+    first = std::max(first, oldest);
+    uint64_t last = newest.count > 0 ? done : done - 1;
+
+    for (uint64_t b = first; b <= last; b++) {
+        float lo, hi;
+        if (b == done) {
+            lo = newest.min;
+            hi = newest.max;
+        } else {
+            size_t slot = level * Capacity + static_cast<size_t>(b % Capacity);
+            lo = mins[slot];
+            hi = maxs[slot];
+        }
+
+        // Columns this bucket's samples fall in
+        int64_t from = static_cast<int64_t>(b * bucketSize) - start;
+        int64_t to = std::min(static_cast<int64_t>((b + 1) * bucketSize), total) - 1 - start;
+        size_t c0 = from > 0 ? static_cast<size_t>(from / perColumn) : 0;
+        size_t c1 = to > 0 ? static_cast<size_t>(to / perColumn) : 0;
+        c1 = std::min(c1, columns - 1);
+
+        for (size_t c = c0; c <= c1; c++) {
+            outMin[c] = std::min(outMin[c], lo);
+            outMax[c] = std::max(outMax[c], hi);
+        }
+    }
+}
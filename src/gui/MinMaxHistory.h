@@ -0,0 +1,57 @@
+#pragma once
+#include <array>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+// Fixed-memory history of one signal for scrolling plots, kept at several
+// resolutions. Level 0 holds the latest Capacity samples; each level above
+// holds the min and max of Factor buckets of the level below, so level k
+// covers Capacity * Factor^k samples in the same space. With the defaults
+// that is 4096 samples at full rate up to ~67 million (about 39 days at
+// 20 Hz) in 256 KB.
+//
+// envelope() answers "min/max per screen column over the last N samples"
+// from the coarsest level whose buckets are still narrower than a column, so
+// a plot costs O(columns) per frame however long the run has been going.
+class MinMaxHistory {
+public:
+    static constexpr size_t Capacity = 4096;   // Buckets kept per level
+    static constexpr size_t Factor = 4;        // Buckets merged into one at the next level
+    static constexpr size_t Levels = 8;
+
+    MinMaxHistory();
+
+    void push(float value);
+
+    // Samples pushed so far
+    uint64_t size() const { return completed[0]; }
+
+    // Longest window still held at some resolution
+    static constexpr uint64_t maxSpan() {
+        uint64_t span = Capacity;
+        for (size_t k = 1; k < Levels; k++) span *= Factor;
+        return span;
+    }
+
+    // Split the last `window` samples into `columns` equal slices and store
+    // each slice's range in mins[i]/maxs[i] (oldest first). A slice with no
+    // data (before the first sample, or older than the history) is returned
+    // with mins[i] > maxs[i].
+    void envelope(uint64_t window, size_t columns, float* mins, float* maxs) const;
+
+private:
+    struct Pending {
+        float min;
+        float max;
+        size_t count;
+    };
+
+    // Range of the newest, not yet complete bucket of `level`
+    Pending partial(size_t level) const;
+
+    std::vector<float> mins;                    // Levels x Capacity, level-major
+    std::vector<float> maxs;
+    std::array<uint64_t, Levels> completed{};  // Buckets completed per level (level 0: samples)
+    std::array<Pending, Levels> pending;        // pending[k]: level k-1 buckets not yet merged into level k
+};
@@ -0,0 +1,296 @@
+#include "BinaryLog.h"
+#include <iostream>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+
+using namespace BinaryLog;
+
+static const char FileMagic[8] = { 'E', 'C', 'U', 'L', 'O', 'G', 'B', '\0' };
+static const uint32_t FileVersion = 1;
+
+// --- Varint helpers ---
+
+static uint64_t zigzag(int64_t v) {
+    return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+}
+
+static int64_t unzigzag(uint64_t v) {
+    return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+}
+
+static void putVarint(std::vector<uint8_t>& out, uint64_t v) {
+    while (v >= 0x80) {
+        out.push_back(static_cast<uint8_t>(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(v));
+}
+
+static bool getVarint(const uint8_t*& p, const uint8_t* end, uint64_t& v) {
+    v = 0;
+    for (unsigned shift = 0; shift < 64 && p < end; shift += 7) {
+        uint8_t byte = *p++;
+        v |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+// llround is unspecified for NaN, infinities and anything past int64, so the
+// scaled value is saturated first (NaN stores as 0). The bound leaves room for
+// the deltas between rows not to overflow either.
+static int64_t quantize(double scaled) {
+    const double limit = 1e15;
+    if (!(scaled == scaled)) return 0;
+    return std::llround(std::min(limit, std::max(-limit, scaled)));
+}
+
+static int64_t toFixed(float value) {
+    return quantize(static_cast<double>(value) * ValueScale);
+}
+
+static int64_t toMicros(double seconds) {
+    return quantize(seconds * TimeScale);
+}
+
+// --- Writer ---
+
+BinaryLogWriter::~BinaryLogWriter() {
+    close();
+}
+
+bool BinaryLogWriter::open(const std::string& filename) {
+    file.open(filename, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "[BinaryLog] Error: Could not open file " << filename << "\n";
+        return false;
+    }
+
+    rows.reserve(ChunkRows);
+    payload.reserve(ChunkRows * 16);
+
+    FileHeader header{};
+    std::memcpy(header.magic, FileMagic, sizeof(FileMagic));
+    header.version = FileVersion;
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    offset = sizeof(header);
+    return true;
+}
+
+void BinaryLogWriter::append(const LogRecord& rec) {
+    if (!file.is_open()) return;
+
+    rows.push_back(rec);
+    if (rows.size() == ChunkRows) flushChunk();
+}
+
+void BinaryLogWriter::flushChunk() {
+    if (rows.empty()) return;
+
+    payload.clear();
+    int64_t firstTime = toMicros(rows.front().timestamp);
+
+    // Time column
+    int64_t prev = firstTime;
+    for (const auto& r : rows) {
+        int64_t t = toMicros(r.timestamp);
+        putVarint(payload, zigzag(t - prev));
+        prev = t;
+    }
+
+    // RPM column
+    prev = 0;
+    for (const auto& r : rows) {
+        putVarint(payload, zigzag(static_cast<int64_t>(r.rpm) - prev));
+        prev = r.rpm;
+    }
+
+    // Fixed-point float columns
+    for (float LogRecord::*column : { &LogRecord::throttle, &LogRecord::coolant, &LogRecord::load, &LogRecord::fuel }) {
+        prev = 0;
+        for (const auto& r : rows) {
+            int64_t q = toFixed(r.*column);
+            putVarint(payload, zigzag(q - prev));
+            prev = q;
+        }
+    }
+
+    // DTC column: a chunk only ever sees a handful of distinct codes
+    std::vector<const char*> dictionary;
+    std::vector<uint32_t> codeIndex;    // Varints on disk: one byte while the dictionary is small
+    codeIndex.reserve(rows.size());
+    for (const auto& r : rows) {
+        size_t i = 0;
+        while (i < dictionary.size() && std::strncmp(dictionary[i], r.activeDTC, sizeof(r.activeDTC)) != 0) i++;
+        if (i == dictionary.size()) dictionary.push_back(r.activeDTC);
+        codeIndex.push_back(static_cast<uint32_t>(i));
+    }
+    putVarint(payload, dictionary.size());
+    for (const char* code : dictionary) {
+        size_t len = strnlen(code, sizeof(LogRecord::activeDTC));
+        payload.push_back(static_cast<uint8_t>(len));
+        payload.insert(payload.end(), code, code + len);
+    }
+    for (uint32_t i : codeIndex) putVarint(payload, i);
+
+    ChunkHeader header{};
+    header.magic = ChunkMagic;
+    header.rowCount = static_cast<uint32_t>(rows.size());
+    header.firstTimeUs = firstTime;
+    header.lastTimeUs = toMicros(rows.back().timestamp);
+    header.payloadBytes = static_cast<uint32_t>(payload.size());
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(payload.data()), static_cast<std::streamsize>(payload.size()));
+
+    index.push_back({ header.firstTimeUs, header.lastTimeUs, offset, header.rowCount, 0 });
+    offset += sizeof(header) + payload.size();
+    rows.clear();
+}
+
+void BinaryLogWriter::close() {
+    if (!file.is_open()) return;
+
+    flushChunk();
+
+    Trailer trailer{};
+    trailer.indexOffset = offset;
+    trailer.chunkCount = static_cast<uint32_t>(index.size());
+    trailer.magic = IndexMagic;
+
+    file.write(reinterpret_cast<const char*>(index.data()), static_cast<std::streamsize>(index.size() * sizeof(IndexEntry)));
+    file.write(reinterpret_cast<const char*>(&trailer), sizeof(trailer));
+    file.close();
+}
+
+// --- Reader ---
+
+bool BinaryLogReader::open(const std::string& filename) {
+    index.clear();
+    if (!mapping.open(filename, MappedFile::Mode::ReadOnly)) return false;
+
+    const uint8_t* base = mapping.data();
+    size_t size = mapping.size();
+
+    FileHeader header{};
+    if (size >= sizeof(header)) std::memcpy(&header, base, sizeof(header));
+    if (std::memcmp(header.magic, FileMagic, sizeof(FileMagic)) != 0 || header.version != FileVersion) {
+        std::cerr << "[BinaryLog] Error: " << filename << " is not a binary ECU log\n";
+        mapping.close();
+        return false;
+    }
+
+    // Normal case: the index at the end of the file
+    Trailer trailer{};
+    if (size >= sizeof(header) + sizeof(trailer)) {
+        std::memcpy(&trailer, base + size - sizeof(trailer), sizeof(trailer));
+    }
+    if (trailer.magic == IndexMagic && trailer.indexOffset >= sizeof(header) && trailer.indexOffset <= size &&
+        trailer.indexOffset + uint64_t(trailer.chunkCount) * sizeof(IndexEntry) + sizeof(trailer) == size) {
+        index.resize(trailer.chunkCount);
+        std::memcpy(index.data(), base + trailer.indexOffset, trailer.chunkCount * sizeof(IndexEntry));
+
+        // Every entry must point at a whole chunk before the index; keep the
+        // chunks up to the first one that doesn't
+        for (size_t i = 0; i < index.size(); i++) {
+            ChunkHeader chunk;
+            if (!validChunk(index[i].offset, trailer.indexOffset, chunk) || chunk.rowCount != index[i].rowCount) {
+                std::cerr << "[BinaryLog] Warning: " << filename << ": index entry " << i
+                          << " is damaged, keeping " << i << " of " << index.size() << " chunks\n";
+                index.resize(i);
+                break;
+            }
+        }
+        return true;
+    }
+
+    // No index (the run didn't shut down cleanly): rebuild it by walking the
+    // chunks, up to the first one that is cut short or damaged
+    uint64_t pos = sizeof(header);
+    ChunkHeader chunk;
+    while (validChunk(pos, size, chunk)) {
+        index.push_back({ chunk.firstTimeUs, chunk.lastTimeUs, pos, chunk.rowCount, 0 });
+        pos += sizeof(chunk) + chunk.payloadBytes;
+    }
+    std::cerr << "[BinaryLog] Warning: " << filename << " has no index, recovered " << index.size() << " chunks\n";
+    return true;
+}
+
+bool BinaryLogReader::validChunk(uint64_t offset, uint64_t limit, ChunkHeader& chunk) const {
+    if (offset < sizeof(FileHeader) || limit > mapping.size() || offset > limit ||
+        limit - offset < sizeof(chunk)) {
+        return false;
+    }
+    std::memcpy(&chunk, mapping.data() + offset, sizeof(chunk));
+    return chunk.magic == ChunkMagic && chunk.rowCount <= ChunkRows &&
+           chunk.payloadBytes <= limit - offset - sizeof(chunk);
+}
+
+size_t BinaryLogReader::findChunk(double timeSec) const {
+    // Before the first row (or NaN) starts at the beginning, past the last
+    // row is the end; only times inside the log get quantized
+    if (index.empty() || !(timeSec > index.front().firstTimeUs / TimeScale)) return 0;
+    if (timeSec > index.back().lastTimeUs / TimeScale) return index.size();
+
+    int64_t t = toMicros(timeSec);
+    auto it = std::lower_bound(index.begin(), index.end(), t,
+        [](const IndexEntry& e, int64_t time) { return e.lastTimeUs < time; });
+    return static_cast<size_t>(it - index.begin());
+}
+
+bool BinaryLogReader::readChunk(size_t chunk, std::vector<LogRecord>& out) const {
+    out.clear();
+    if (chunk >= index.size()) return false;
+
+    ChunkHeader header;
+    std::memcpy(&header, mapping.data() + index[chunk].offset, sizeof(header));
+    const uint8_t* p = mapping.data() + index[chunk].offset + sizeof(header);
+    const uint8_t* end = p + header.payloadBytes;
+
+    out.resize(header.rowCount);
+    uint64_t v;
+
+    int64_t prev = header.firstTimeUs;
+    for (auto& r : out) {
+        if (!getVarint(p, end, v)) return false;
+        prev += unzigzag(v);
+        r.timestamp = prev / TimeScale;
+    }
+
+    prev = 0;
+    for (auto& r : out) {
+        if (!getVarint(p, end, v)) return false;
+        prev += unzigzag(v);
+        r.rpm = static_cast<int>(prev);
+    }
+
+    for (float LogRecord::*column : { &LogRecord::throttle, &LogRecord::coolant, &LogRecord::load, &LogRecord::fuel }) {
+        prev = 0;
+        for (auto& r : out) {
+            if (!getVarint(p, end, v)) return false;
+            prev += unzigzag(v);
+            r.*column = static_cast<float>(prev / ValueScale);
+        }
+    }
+
+    // Each entry takes at least its length byte, so a count beyond the
+    // remaining payload is corrupt (and must not size the vector)
+    uint64_t dictSize;
+    if (!getVarint(p, end, dictSize) || dictSize > static_cast<uint64_t>(end - p)) return false;
+    std::vector<std::array<char, sizeof(LogRecord::activeDTC)>> dictionary(dictSize);
+    for (auto& code : dictionary) {
+        if (p >= end) return false;
+        size_t len = std::min<size_t>(*p++, code.size() - 1);
+        if (p + len > end) return false;
+        code.fill('\0');
+        std::memcpy(code.data(), p, len);
+        p += len;
+    }
+    for (auto& r : out) {
+        if (!getVarint(p, end, v) || v >= dictionary.size()) return false;
+        std::memcpy(r.activeDTC, dictionary[v].data(), sizeof(r.activeDTC));
+    }
+    return true;
+}
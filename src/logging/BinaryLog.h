@@ -0,0 +1,112 @@
+#pragma once
+#include <fstream>
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include "LogRecord.h"
+#include "../common/MappedFile.h"
+
+// Compact binary telemetry log (.ecb)
+//
+//   [FileHeader] [Chunk]... [IndexEntry]... [Trailer]
+//
+// Rows are grouped into chunks of up to ChunkRows. Inside a chunk each column
+// is stored on its own, delta-encoded against the previous row and written as
+// zigzag varints, so slowly changing signals take one or two bytes per row:
+//   time        microseconds
+//   rpm         integer
+//   throttle, coolant, load, fuel   fixed point, 0.001 resolution
+//                                   (rounded to the nearest 1/ValueScale on
+//                                   write, so lossy: the CSV logger keeps 6
+//                                   significant digits, e.g. 91.2346 here
+//                                   reads back as 91.235)
+//   DTC         per-chunk dictionary + one varint index per row (any number
+//               of distinct codes)
+// The trailing index lists every chunk's time range and file offset, so a
+// reader can seek straight to any point in a multi-hour run.
+namespace BinaryLog {
+
+constexpr size_t ChunkRows = 4096;
+constexpr double TimeScale = 1e6;       // Seconds -> microseconds
+constexpr double ValueScale = 1000.0;   // Physical value -> fixed point
+
+struct FileHeader {
+    char magic[8];          // "ECULOGB\0"
+    uint32_t version;
+    uint32_t reserved;
+};
+
+struct ChunkHeader {
+    uint32_t magic;         // ChunkMagic
+    uint32_t rowCount;
+    int64_t firstTimeUs;
+    int64_t lastTimeUs;
+    uint32_t payloadBytes;
+    uint32_t reserved;
+};
+
+struct IndexEntry {
+    int64_t firstTimeUs;
+    int64_t lastTimeUs;
+    uint64_t offset;        // File offset of the ChunkHeader
+    uint32_t rowCount;
+    uint32_t reserved;
+};
+
+struct Trailer {
+    uint64_t indexOffset;
+    uint32_t chunkCount;
+    uint32_t magic;         // IndexMagic
+};
+
+constexpr uint32_t ChunkMagic = 0x4B4E4843;   // "CHNK"
+constexpr uint32_t IndexMagic = 0x5844494C;   // "LIDX"
+
+} // namespace BinaryLog
+
+class BinaryLogWriter {
+public:
+    ~BinaryLogWriter();
+
+    bool open(const std::string& filename);
+    bool isOpen() const { return file.is_open(); }
+
+    void append(const LogRecord& rec);
+
+    // Write the last partial chunk and the index
+    void close();
+
+private:
+    void flushChunk();
+
+    std::ofstream file;
+    uint64_t offset = 0;
+    std::vector<LogRecord> rows;                 // Current chunk, reserved once
+    std::vector<uint8_t> payload;                // Encoding scratch, reused
+    std::vector<BinaryLog::IndexEntry> index;
+};
+
+class BinaryLogReader {
+public:
+    bool open(const std::string& filename);
+    bool isOpen() const { return mapping.isOpen(); }
+
+    size_t getChunkCount() const { return index.size(); }
+    const BinaryLog::IndexEntry& getChunk(size_t chunk) const { return index[chunk]; }
+
+    // First chunk that may contain rows at or after timeSec: 0 before the
+    // log starts, getChunkCount() past its end
+    size_t findChunk(double timeSec) const;
+
+    // Decode one chunk's rows (out is cleared first)
+    bool readChunk(size_t chunk, std::vector<LogRecord>& out) const;
+
+private:
+    // True if a whole chunk (header and payload) starts at `offset` and ends
+    // by `limit`; its header is copied to `chunk`
+    bool validChunk(uint64_t offset, uint64_t limit, BinaryLog::ChunkHeader& chunk) const;
+
+    MappedFile mapping;
+    std::vector<BinaryLog::IndexEntry> index;
+};
@@ -0,0 +1,12 @@
+#pragma once
+
+// One row of telemetry, fixed size so it can be queued and stored without allocation
+struct LogRecord {
+    double timestamp;       // Seconds since the start of the run
+    int rpm;
+    float throttle;
+    float coolant;
+    float load;
+    float fuel;             // Injection time (ms)
+    char activeDTC[8];      // "P0217" fits; longer codes are truncated
+};
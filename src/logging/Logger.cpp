@@ -1,36 +1,116 @@
 #include "Logger.h"
 #include <iostream>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+// Records formatted per write() call
+static const size_t BatchSize = 512;
+
+Logger::Logger(const std::string& filename, Format format) : format(format) {
+    bool opened;
+    if (format == Format::Binary) {
+        opened = binary.open(filename); // Writes its own file header
+    } else {
+        file.open(filename, std::ios::out | std::ios::trunc); // 'trunc' overwrites the file every restart
+        opened = file.is_open();
 
-Logger::Logger(const std::string& filename) {
-    file.open(filename, std::ios::out | std::ios::trunc); // 'trunc' overwrites the file every restart
-    
-    if (file.is_open()) {
         // Write CSV Header
-        file << "Time(s),RPM,Throttle(%),Coolant(C),Load(Nm),Injection(ms),DTC\n";
+        if (opened) file << "Time(s),RPM,Throttle(%),Coolant(C),Load(Nm),Injection(ms),DTC\n";
+    }
+    
+    if (opened) {
+        formatBuffer.reserve(BatchSize * 96);
+        running = true;
+        writer = std::thread(&Logger::writerLoop, this);
     } else {
         std::cerr << "[Logger] Error: Could not open file " << filename << "\n";
     }
 }
 
 Logger::~Logger() {
+    if (writer.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(wakeMutex);
+            running = false;
+        }
+        wake.notify_one();
+        writer.join();
+    }
+
     if (file.is_open()) {
         file.close();
     }
+    binary.close(); // Last chunk + seek index
+
+    if (getDroppedCount() > 0) {
+        std::cerr << "[Logger] Warning: Dropped " << getDroppedCount() << " records (writer could not keep up)\n";
+    }
 }
 
-void Logger::log(double timestamp, int rpm, float throttle, float coolant, float load, float fuel, const std::string& activeDTC) {
-    std::lock_guard<std::mutex> lock(logMutex); // Protect the file access
-    
-    if (file.is_open()) {
-        file << timestamp << "," 
-             << rpm << "," 
-             << throttle << "," 
-             << coolant << "," 
-             << load << ","
-             << fuel << ","
-             << (activeDTC.empty() ? "None" : activeDTC) << "\n";
-             
-        // Optional: Flush to ensure data is saved immediately (slower, but safer if crash)
-        // file.flush(); 
+void Logger::log(double timestamp, int rpm, float throttle, float coolant, float load, float fuel, const char* activeDTC) {
+    if (!running.load(std::memory_order_relaxed)) return;
+
+    LogRecord rec;
+    rec.timestamp = timestamp;
+    rec.rpm = rpm;
+    rec.throttle = throttle;
+    rec.coolant = coolant;
+    rec.load = load;
+    rec.fuel = fuel;
+
+    const char* dtc = (!activeDTC || !*activeDTC) ? "None" : activeDTC;
+    std::strncpy(rec.activeDTC, dtc, sizeof(rec.activeDTC) - 1);
+    rec.activeDTC[sizeof(rec.activeDTC) - 1] = '\0';
+
+    if (!queue.tryPush(rec)) {
+        droppedCount.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void Logger::writerLoop() {
+    for (;;) {
+        bool stopping = !running.load();
+        size_t written = writeBatch();
+
+        if (written == 0) {
+            if (stopping) break; // Queue fully drained after shutdown was requested
+
+            // Idle: nap briefly. log() never notifies, so the control task
+            // doesn't pay for a wakeup on every row.
+            std::unique_lock<std::mutex> lock(wakeMutex);
+            wake.wait_for(lock, std::chrono::milliseconds(20), [this] { return !running.load(); });
+        }
+    }
+    if (format == Format::Csv) file.flush();
+}
+
+size_t Logger::writeBatch() {
+    size_t count = 0;
+    LogRecord rec;
+
+    if (format == Format::Binary) {
+        while (count < BatchSize && queue.tryPop(rec)) {
+            binary.append(rec);     // Encodes and writes a chunk every BinaryLog::ChunkRows rows
+            count++;
+        }
+        return count;
+    }
+
+    formatBuffer.clear();
+    char line[160];
+    while (count < BatchSize && queue.tryPop(rec)) {
+        // %g matches the default std::ostream formatting of the old writer
+        int len = std::snprintf(line, sizeof(line), "%g,%d,%g,%g,%g,%g,%s\n",
+                                rec.timestamp, rec.rpm, rec.throttle, rec.coolant,
+                                rec.load, rec.fuel, rec.activeDTC);
+        if (len > 0) formatBuffer.append(line, static_cast<size_t>(len));
+        count++;
+    }
+
+    // One write() for the whole batch
+    if (!formatBuffer.empty()) {
+        file.write(formatBuffer.data(), static_cast<std::streamsize>(formatBuffer.size()));
     }
+    return count;
 }
@@ -2,20 +2,50 @@
 #include <string>
 #include <fstream>
 #include <mutex>
+#include <thread>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include "../common/RingBuffer.h"
+#include "LogRecord.h"
+#include "BinaryLog.h"
 
 class Logger {
 public:
-    // Open the file and write the CSV headers
-    Logger(const std::string& filename);
+    // Records the queue can hold before log() starts dropping them
+    static constexpr size_t QueueCapacity = 8192;
+
+    // Csv:    human-readable text (ecu_log.csv)
+    // Binary: compact columnar format with a seek index (see BinaryLog.h);
+    //         convert back to CSV with ecu_log2csv
+    enum class Format { Csv, Binary };
+
+    // Open the file, write the headers and start the writer thread
+    Logger(const std::string& filename, Format format = Format::Csv);
     
-    // Close the file properly
+    // Write out everything still queued, then close the file properly
     ~Logger();
     
-    // Write one row of data
-    void log(double timestamp, int rpm, float throttle, float coolant, float load, float fuel, const std::string& activeDTC);
+    // Queue one row of data. Copies a fixed-size record and returns; the
+    // formatting and file I/O happen on the writer thread. Never blocks.
+    void log(double timestamp, int rpm, float throttle, float coolant, float load, float fuel, const char* activeDTC);
+
+    // Rows lost because the writer couldn't keep up
+    uint64_t getDroppedCount() const { return droppedCount.load(std::memory_order_relaxed); }
 
 private:
-    std::ofstream file;
-    std::mutex logMutex; // Ensures thread safety if multiple tasks try to log
-};
+    void writerLoop();
+    size_t writeBatch();        // Returns how many records were written
+
+    Format format;
+    std::ofstream file;         // Csv
+    BinaryLogWriter binary;     // Binary
+    RingBuffer<LogRecord, QueueCapacity> queue;
+    std::atomic<uint64_t> droppedCount{0};
 
+    std::string formatBuffer;   // Reused for every batch
+    std::atomic<bool> running{false};
+    std::mutex wakeMutex;
+    std::condition_variable wake;
+    std::thread writer;
+};
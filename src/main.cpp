@@ -1,162 +1,35 @@
 #include <iostream>
+#include <array>
 #include <iomanip>
 #include <thread>
 #include <atomic>
+#include <memory>
+#include <cstdlib>
+#include <string>
+#include <chrono>
+#include <cstdint>
 
 // Modules
-#include "scheduler/Scheduler.h"
-#include "sensors/SensorModule.h"
-#include "engine/FuelControl.h"
-#include "engine/EnginePhysics.h"
-#include "dtc/DTCManager.h"
-#include "can/CANBus.h"
-#include "logging/Logger.h"
 #include "ECUState.h"
+#include "sim/EcuTasks.h"
 
 // GUI Includes
 #include "imgui.h"
 #include "imgui_impl_glfw.h"
 #include "imgui_impl_opengl3.h"
 #include <GLFW/glfw3.h>
+#include "gui/HistoryPlot.h"
 
 // --- GLOBAL SHARED STATE ---
 ECUState ecuState;
 std::atomic<bool> appRunning(true); // Flag to stop threads when window closes
 
 // --- THE ECU THREAD (Background Logic) ---
+// The task set itself lives in src/sim/EcuTasks.cpp, shared with ecu_headless;
+// here it is configured from the ECU_* environment variables and runs until
+// the window closes.
 void ecuTask() {
-    SensorModule sensors;
-    FuelControl fuel;
-    Scheduler scheduler;
-    DTCManager dtc;
-    CANBus canBus;
-    EnginePhysics engine;
-    Logger logger("ecu_log.csv"); 
-    
-    float currentLoad = 0.0f;
-    auto startTime = std::chrono::steady_clock::now();
-
-    // TASK 1: Physics (10ms)
-    scheduler.addTask([&]() {
-
-        float throttle = sensors.getThrottle();
-        if (throttle < 1.0f && engine.getRPM() < 650) throttle = 6.0f; // Anti-stall
-        engine.update(throttle, currentLoad, 0.01f)
-        ;
-        sensors.setSimulatedRPM((int)engine.getRPM());
-
-    }, 10);
-
-    // TASK 2: Logic & Shared State Update (50ms)
-    scheduler.addTask([&]() {
-        int rpm = sensors.getRPM();
-        float throttle = sensors.getThrottle();
-        float coolant = sensors.getCoolantTemp();
-        float inj = fuel.calculateInjectionTime(rpm, throttle, 30.0f);
-        
-        // Get Faults
-        std::string code = "None";
-        const auto& faults = dtc.getActiveFaults();
-        if(!faults.empty() && faults[0].active) code = faults[0].code;
-
-        // --- UPDATE SHARED STATE FOR GUI ---
-        ecuState.update(rpm, throttle, coolant, currentLoad, inj, code);
-
-        // Fault Logic
-        if (coolant > 92.0f) dtc.addFault("P0217", "Engine Overheat");
-
-    }, 50);
-
-    // TASK 3: Print Active Faults to Console (1000ms) <--- ADDED THIS FOR YOU
-    scheduler.addTask([&]() {
-        const auto& faults = dtc.getActiveFaults();
-        
-        bool headerPrinted = false;
-        
-        for(const auto& f : faults) {
-            if(f.active) {
-                if(!headerPrinted) {
-                    std::cout << "\n!!! ACTIVE DTCs !!!\n";
-                    headerPrinted = true;
-                }
-                std::cout << "  CODE: " << f.code << " - " << f.message << "\n";
-            }
-        }
-        
-        if(headerPrinted) {
-            std::cout << "!!!!!!!!!!!!!!!!!!!\n\n";
-        }
-    }, 1000);
-
-    scheduler.addTask([&]() {
-        int rpm = sensors.getRPM();
-        float throttle = sensors.getThrottle();
-        float coolant = sensors.getCoolantTemp();
-        
-        // Calculate Fuel
-        // We now calculate specific injection time (ms), and we'll use 30°C as a dummy Intake Temp for now
-        float pulseWidth = fuel.calculateInjectionTime(rpm, throttle, 30.0f); // Updated from Lesson 5
-
-        // Print Dashboard
-        std::cout << std::fixed << std::setprecision(1);
-        std::cout << "RPM: " << std::setw(4) << rpm 
-                  << " | Throttle: " << std::setw(4) << throttle << "%"
-                  << " | Load: " << currentLoad << "Nm"
-                  << " | Coolant: " << coolant << "C"
-                  << " | Inj: " << pulseWidth << "ms" 
-                  << "\n";
-
-    }, 100);
-
-    // --- TASK 5: CAN Receiver (TCU Simulation) (100ms) ---
-    // Reads messages from the bus. If ID 0x200 (Transmission) asks for low torque,
-    // we simulate a high load on the engine.
-    scheduler.addTask([&]() {
-        auto msgs = canBus.readMessages();
-        for(const auto& m : msgs) {
-            if(m.id == 0x200) {
-                int torqueReq = m.data[0];
-
-                // DEBUG PRINT: Show we received it
-                std::cout << "[CAN-RX] ID: 0x200 | TorqueReq: " << torqueReq << "Nm\n";
-
-                if (torqueReq < 100) {
-                    currentLoad = 80.0f; // Apply "Brake" load
-                    std::cout << ">>> [ECU] TCU Requested Torque Reduction -> Applying Load!\n";
-                } else {
-                    currentLoad = 0.0f;
-                }
-            }
-        }
-    }, 100);
-
-    // --- TASK 6: Transmission Simulation (3000ms) ---
-    // Simulates an external Transmission module sending commands every 3 seconds
-    scheduler.addTask([&]() {
-        CANMessage msg;
-        msg.id = 0x200;
-        static bool toggle = false;
-        toggle = !toggle;
-
-        // Toggle between "Drive Normally" (200Nm) and "Shift" (50Nm)
-        msg.data[0] = toggle ? 200 : 50; 
-        msg.data[1] = 3; // Gear 3
-        canBus.sendMessage(msg);
-
-        // DEBUG PRINT: Show we sent it
-        std::cout << "[TCU-TX] Sending Gear Shift Command: " << (int)msg.data[0] << "Nm\n";
-    }, 3000);
-
-    // Run until app closes
-    while (appRunning) {
-        // We manually tick the scheduler logic here.
-        // Ideally, Scheduler should have a safe loop, but we will rely on 
-        // its internal loop or run it carefully.
-        // Since your Scheduler::run() is an infinite loop, we can't easily break it
-        // from outside without modifying Scheduler.h.
-        // For now, this thread will just die when main() exits, which is acceptable for a sim.
-        scheduler.run(); 
-    }
+    runEcu(EcuConfig::fromEnvironment(), ecuState, appRunning);
 }
 
 // --- MAIN (GUI Thread) ---
@@ -172,7 +45,7 @@ int main() {
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 0);
 
-    GLFWwindow* window = glfwCreateWindow(800, 600, "ECU Simulator Pro", nullptr, nullptr);
+    GLFWwindow* window = glfwCreateWindow(800, 820, "ECU Simulator Pro", nullptr, nullptr);
     if (!window) return 1;
     glfwMakeContextCurrent(window);
     glfwSwapInterval(1); // Enable V-Sync
@@ -184,6 +57,18 @@ int main() {
     ImGui_ImplGlfw_InitForOpenGL(window, true);
     ImGui_ImplOpenGL3_Init(glsl_version);
 
+    // Trend plots, fed every snapshot the logic task publishes (every 50 ms)
+    constexpr double TrendPeriod = 0.05;
+    const struct { const char* label; double seconds; } trendWindows[] = {
+        { "1 min", 60.0 }, { "10 min", 600.0 }, { "1 h", 3600.0 }, { "8 h", 8 * 3600.0 }
+    };
+    HistoryPlot rpmTrend("RPM", "rpm", 0.0f, 7500.0f, IM_COL32(80, 220, 80, 255));
+    HistoryPlot injectionTrend("Injection", "ms", 0.0f, 20.0f, IM_COL32(240, 180, 60, 255));
+    HistoryPlot loadTrend("Load", "Nm", 0.0f, 100.0f, IM_COL32(90, 160, 250, 255));
+    HistoryPlot coolantTrend("Coolant", "C", 60.0f, 120.0f, IM_COL32(240, 90, 90, 255));
+    uint64_t trendVersion = 0;
+    int trendWindow = 0;
+
     // 4. GUI Loop
     while (!glfwWindowShouldClose(window)) {
         glfwPollEvents();
@@ -194,8 +79,18 @@ int main() {
         ImGui::NewFrame();
 
         // --- READ DATA FROM ECU ---
+        uint64_t version = ecuState.getVersion();
         ECUData data = ecuState.read();
 
+        // Only new snapshots go into the trends, not every GUI frame
+        if (version != trendVersion) {
+            trendVersion = version;
+            rpmTrend.push(static_cast<float>(data.rpm));
+            injectionTrend.push(data.injectionMs);
+            loadTrend.push(data.load);
+            coolantTrend.push(data.coolant);
+        }
+
         // --- DRAW DASHBOARD ---
         // Make the window cover the whole application
         ImGui::SetNextWindowPos(ImVec2(0, 0));
@@ -241,19 +136,34 @@ int main() {
 
         // DTC DISPLAY
         ImGui::Text("DIAGNOSTICS:");
-        if (data.activeDTC != "None") {
+        if (data.hasDTC()) {
             // Big Red Box for DTC
             ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(1, 1, 0, 1)); // Yellow Text
             ImGui::Text("STATUS: CRITICAL FAULT");
             ImGui::PopStyleColor();
             
             ImGui::SetWindowFontScale(2.0f); // Make text huge
-            ImGui::TextColored(ImVec4(1, 0, 0, 1), "[ %s ]", data.activeDTC.c_str());
+            ImGui::TextColored(ImVec4(1, 0, 0, 1), "[ %s ]", data.activeDTC);
             ImGui::SetWindowFontScale(1.0f); // Reset font
         } else {
             ImGui::TextColored(ImVec4(0, 1, 0, 1), "SYSTEM OK");
         }
 
+        ImGui::Spacing();
+        ImGui::Separator();
+
+        // TRENDS (min/max envelope per pixel column, any length of run)
+        ImGui::Text("TRENDS:");
+        for (int i = 0; i < static_cast<int>(sizeof(trendWindows) / sizeof(trendWindows[0])); i++) {
+            ImGui::SameLine();
+            if (ImGui::RadioButton(trendWindows[i].label, trendWindow == i)) trendWindow = i;
+        }
+        uint64_t trendSpan = static_cast<uint64_t>(trendWindows[trendWindow].seconds / TrendPeriod);
+        rpmTrend.draw(trendSpan, 60.0f);
+        injectionTrend.draw(trendSpan, 60.0f);
+        loadTrend.draw(trendSpan, 60.0f);
+        coolantTrend.draw(trendSpan, 60.0f);
+
         ImGui::End(); // End Dashboard Window
 
         // Rendering
@@ -366,7 +276,7 @@ int main() {
 //             std::cout << "\n!!! ACTIVE DTCs !!!\n";
 //             for(const auto& f : faults) {
 //                 if(f.active) 
-//                     std::cout << "  CODE: " << f.code << " - " << f.message << "\n";
+//                     std::cout << "  CODE: " << dtcToString(f.code) << " - " << f.message << "\n";
 //             }
 //             std::cout << "!!!!!!!!!!!!!!!!!!!\n\n";
 //         }
@@ -0,0 +1,58 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Layout of the simulated flash chip image (ecu_flash.img). The file is a raw
+// dump of the chip, so it can be handed to flashing tools as-is:
+//
+//   offset    size     partition
+//   0x00000    4 KiB   partition table (ImageHeader)
+//   0x01000   64 KiB   "dtc"    DTC journal (16 sectors, see FlashMemory)
+//   0x11000   64 KiB   "freeze" freeze frames
+//   0x21000   16 KiB   "calib"  calibration data
+//
+// Erased flash reads 0xFF. All fields are little-endian.
+namespace FlashLayout {
+    constexpr size_t SectorSize = 4096;
+
+    enum class Partition : uint32_t { DtcJournal = 1, FreezeFrames = 2, Calibration = 3 };
+
+    struct PartitionEntry {
+        char name[8];
+        uint32_t type;          // Partition
+        uint32_t offset;        // From the start of the image, sector aligned
+        uint32_t size;          // Whole sectors
+        uint32_t reserved;
+    };
+
+    constexpr size_t PartitionCount = 3;
+
+    constexpr PartitionEntry Partitions[PartitionCount] = {
+        { "dtc",    static_cast<uint32_t>(Partition::DtcJournal),   0x01000, 0x10000, 0 },
+        { "freeze", static_cast<uint32_t>(Partition::FreezeFrames), 0x11000, 0x10000, 0 },
+        { "calib",  static_cast<uint32_t>(Partition::Calibration),  0x21000, 0x04000, 0 },
+    };
+
+    constexpr size_t ImageSize = 0x25000;
+
+    // Sector 0
+    struct ImageHeader {
+        char magic[8];          // "ECUFLSH"
+        uint32_t version;
+        uint32_t imageSize;
+        uint32_t partitionCount;
+        PartitionEntry partitions[PartitionCount];
+        uint32_t crc;           // CRC-32 of everything above
+    };
+
+    constexpr uint32_t Version = 1;
+
+    constexpr const PartitionEntry& entry(Partition p) {
+        return Partitions[static_cast<uint32_t>(p) - 1];
+    }
+
+    static_assert(sizeof(PartitionEntry) == 24, "PartitionEntry layout");
+    static_assert(sizeof(ImageHeader) <= SectorSize, "Partition table must fit sector 0");
+    static_assert(Partitions[PartitionCount - 1].offset + Partitions[PartitionCount - 1].size == ImageSize,
+                  "Partitions must fill the image");
+}
@@ -1,40 +1,398 @@
 #include "FlashMemory.h"
+#include "../common/Crc32.h"
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
 
-const std::string FlashMemory::FILENAME = "ecu_nvram.txt"; // Our "Flash Chip"
+static const uint32_t SectorMagic = 0x4D564E45; // "ENVM"
+static const uint32_t Unwritten = 0xFFFFFFFF;
+static const char ImageMagic[8] = { 'E', 'C', 'U', 'F', 'L', 'S', 'H', '\0' };
 
-void FlashMemory::saveDTCs(const std::vector<DTC>& faults) {
-    std::ofstream file(FILENAME);
-    if (file.is_open()) {
-        for (const auto& dtc : faults) {
-            // Format: CODE,MESSAGE (e.g., P0217,Engine Overheat)
-            if (dtc.active) {
-                file << dtc.code << "," << dtc.message << "\n";
-            }
+static_assert(sizeof(FlashMemory::SectorHeader) == 64, "SectorHeader layout");
+static_assert(sizeof(FlashMemory::Record) == 64, "Record layout");
+static_assert(FlashMemory::SectorCount >= 3, "Journal needs an active, a spare and an oldest sector");
+
+static uint32_t recordCrc(const FlashMemory::Record& rec) {
+    return crc32(&rec, offsetof(FlashMemory::Record, crc));
+}
+
+FlashMemory::FlashMemory(const std::string& filename)
+    : filename(filename) {
+    mount();
+    if (journal) {
+        running = true;
+        writer = std::thread(&FlashMemory::writerLoop, this);
+    }
+}
+
+FlashMemory::~FlashMemory() {
+    if (writer.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(wakeMutex);
+            running = false;
         }
-        file.close();
+        wake.notify_one();
+        writer.join();
+    }
+    if (getDroppedCount() > 0) {
+        std::cerr << "[FlashMemory] Warning: Dropped " << getDroppedCount() << " DTC commits (queue full)\n";
     }
 }
 
-std::vector<DTC> FlashMemory::loadDTCs() {
-    std::vector<DTC> loadedFaults;
-    std::ifstream file(FILENAME);
-    
-    if (file.is_open()) {
-        std::string line;
-        while (std::getline(file, line)) {
-            // Parse "P0217,Engine Overheat"
-            std::stringstream ss(line);
-            std::string code, message;
-            
-            if (std::getline(ss, code, ',') && std::getline(ss, message)) {
-                loadedFaults.push_back({ code, message, true }); // Mark as active
-                std::cout << "[FlashMemory] Restored stored fault: " << code << "\n";
+// --- Image ---
+
+bool FlashMemory::mapImage() {
+    using namespace FlashLayout;
+
+    if (!image.open(filename, MappedFile::Mode::ReadWrite, ImageSize)) return false;
+    if (image.size() < ImageSize) {
+        std::cerr << "[FlashMemory] Error: " << filename << " is smaller than the flash image\n";
+        image.close();
+        return false;
+    }
+
+    ImageHeader* table = reinterpret_cast<ImageHeader*>(image.data());
+    bool valid = std::memcmp(table->magic, ImageMagic, sizeof(ImageMagic)) == 0
+              && table->version == Version
+              && table->imageSize == ImageSize
+              && table->partitionCount == PartitionCount
+              && std::memcmp(table->partitions, Partitions, sizeof(Partitions)) == 0
+              && table->crc == crc32(table, offsetof(ImageHeader, crc));
+    if (!valid) {
+        // New file (zero-filled by the mapping) or a different layout: blank
+        // the chip and write our partition table
+        std::memset(image.data(), 0xFF, ImageSize);
+        std::memcpy(table->magic, ImageMagic, sizeof(ImageMagic));
+        table->version = Version;
+        table->imageSize = ImageSize;
+        table->partitionCount = PartitionCount;
+        std::memcpy(table->partitions, Partitions, sizeof(Partitions));
+        table->crc = crc32(table, offsetof(ImageHeader, crc));
+        image.flush(0, ImageSize);
+    }
+
+    journal = image.data() + entry(Partition::DtcJournal).offset;
+    return !valid;
+}
+
+uint8_t* FlashMemory::getPartition(FlashLayout::Partition partition) {
+    return image.isOpen() ? image.data() + FlashLayout::entry(partition).offset : nullptr;
+}
+
+size_t FlashMemory::getPartitionSize(FlashLayout::Partition partition) const {
+    return image.isOpen() ? FlashLayout::entry(partition).size : 0;
+}
+
+bool FlashMemory::flushPartition(FlashLayout::Partition partition, size_t offset, size_t count) {
+    return image.flush(FlashLayout::entry(partition).offset + offset, count);
+}
+
+// --- Emulated chip ---
+
+const FlashMemory::SectorHeader& FlashMemory::header(size_t sector) const {
+    return *reinterpret_cast<const SectorHeader*>(journal + sector * SectorSize);
+}
+
+const FlashMemory::Record& FlashMemory::slot(size_t sector, size_t index) const {
+    return *reinterpret_cast<const Record*>(journal + sector * SectorSize + sizeof(SectorHeader) + index * sizeof(Record));
+}
+
+bool FlashMemory::isErased(size_t offset, size_t count) const {
+    return std::all_of(journal + offset, journal + offset + count, [](uint8_t b) { return b == 0xFF; });
+}
+
+bool FlashMemory::program(size_t offset, const void* bytes, size_t count) {
+    // Flash can only clear bits; writing over programmed bytes needs an erase first
+    if (!isErased(offset, count)) {
+        std::cerr << "[FlashMemory] Error: program at offset " << offset << " without erase\n";
+        return false;
+    }
+    std::memcpy(journal + offset, bytes, count);
+    return flushPartition(FlashLayout::Partition::DtcJournal, offset, count);
+}
+
+void FlashMemory::erase(size_t sector) {
+    uint32_t eraseCount = header(sector).magic == SectorMagic ? header(sector).eraseCount + 1 : 1;
+
+    size_t offset = sector * SectorSize;
+    std::memset(journal + offset, 0xFF, SectorSize);
+    flushPartition(FlashLayout::Partition::DtcJournal, offset, SectorSize);
+
+    // Header goes on right after the erase; the generation stays blank until
+    // the journal opens the sector
+    SectorHeader h;
+    std::memset(&h, 0xFF, sizeof(h));
+    h.magic = SectorMagic;
+    h.eraseCount = eraseCount;
+    program(offset, &h, sizeof(h));
+}
+
+uint32_t FlashMemory::getEraseCount(size_t sector) const {
+    std::lock_guard<std::mutex> lock(flashMutex);
+    if (sector >= SectorCount || header(sector).magic != SectorMagic) return 0;
+    return header(sector).eraseCount;
+}
+
+// --- Journal ---
+
+bool FlashMemory::isValid(const Record& rec) const {
+    return rec.sequence != Unwritten && rec.messageLength <= MessageSize && rec.crc == recordCrc(rec);
+}
+
+void FlashMemory::mount() {
+    std::lock_guard<std::mutex> lock(flashMutex);
+
+    // One mmap: everything below reads the journal in place
+    bool fresh = mapImage();
+    if (!journal) {
+        std::cerr << "[FlashMemory] Error: Could not map " << filename << "\n";
+        return;
+    }
+
+    if (fresh) {
+        format();
+        importText("ecu_nvram.txt");
+        return;
+    }
+
+    // Sectors with a bad header (e.g., power lost mid-erase) are erased again
+    bool anyOpen = false;
+    for (size_t s = 0; s < SectorCount; s++) {
+        if (header(s).magic != SectorMagic) {
+            erase(s);
+            continue;
+        }
+        uint32_t gen = header(s).generation;
+        if (gen != Unwritten && (!anyOpen || gen >= nextGeneration)) {
+            activeSector = s;
+            nextGeneration = gen + 1;
+            anyOpen = true;
+        }
+        for (size_t i = 0; i < RecordsPerSector; i++) {
+            if (isValid(slot(s, i))) nextSequence = std::max(nextSequence, slot(s, i).sequence + 1);
+        }
+    }
+
+    if (!anyOpen) {
+        format();
+        return;
+    }
+
+    // Resume after the last programmed slot (a torn record is skipped, not reused)
+    nextSlot = 0;
+    for (size_t i = RecordsPerSector; i > 0; i--) {
+        size_t offset = activeSector * SectorSize + sizeof(SectorHeader) + (i - 1) * sizeof(Record);
+        if (!isErased(offset, sizeof(Record))) {
+            nextSlot = i;
+            break;
+        }
+    }
+
+    // Power lost during compaction: finish it, so the next sector is a spare again
+    size_t spare = (activeSector + 1) % SectorCount;
+    if (header(spare).generation != Unwritten ||
+        !isErased(spare * SectorSize + sizeof(SectorHeader), SectorSize - sizeof(SectorHeader))) {
+        compact(spare);
+    }
+}
+
+void FlashMemory::format() {
+    for (size_t s = 0; s < SectorCount; s++) erase(s);
+
+    activeSector = 0;
+    nextSlot = 0;
+    nextSequence = 0;
+    nextGeneration = 1;
+    program(offsetof(SectorHeader, generation), &nextGeneration, sizeof(uint32_t));
+    nextGeneration++;
+}
+
+void FlashMemory::importText(const std::string& textFile) {
+    std::ifstream file(textFile);
+    if (!file.is_open()) return;
+
+    std::string line;
+    while (std::getline(file, line)) {
+        // Parse "P0217,Engine Overheat"
+        std::stringstream ss(line);
+        std::string code, message;
+        DTCCode value = 0;
+
+        if (std::getline(ss, code, ',') && std::getline(ss, message)) {
+            if (!parseDTC(code.c_str(), value)) {
+                std::cerr << "[FlashMemory] Error: skipping bad code '" << code << "'\n";
+                continue;
             }
+            Record rec{};
+            rec.code = value;
+            rec.active = 1;
+            rec.messageLength = static_cast<uint8_t>(std::min(message.size(), MessageSize));
+            std::memcpy(rec.message, message.data(), rec.messageLength);
+            append(rec);
+            std::cout << "[FlashMemory] Imported fault from " << textFile << ": " << code << "\n";
+        }
+    }
+}
+
+void FlashMemory::append(Record rec) {
+    while (nextSlot == RecordsPerSector) openNextSector();
+
+    rec.sequence = nextSequence++;
+    rec.crc = recordCrc(rec);
+    size_t offset = activeSector * SectorSize + sizeof(SectorHeader) + nextSlot * sizeof(Record);
+    nextSlot++;
+    program(offset, &rec, sizeof(rec));
+}
+
+void FlashMemory::openNextSector() {
+    // The next sector is always an erased spare
+    activeSector = (activeSector + 1) % SectorCount;
+    nextSlot = 0;
+    uint32_t gen = nextGeneration++;
+    program(activeSector * SectorSize + offsetof(SectorHeader, generation), &gen, sizeof(gen));
+
+    // Make a new spare out of the oldest sector
+    compact((activeSector + 1) % SectorCount);
+}
+
+void FlashMemory::compact(size_t sector) {
+    // At most once around the chip; see below
+    for (size_t pass = 0; pass < SectorCount; pass++) {
+        if (pass > 0 && header(sector).generation == Unwritten &&
+            isErased(sector * SectorSize + sizeof(SectorHeader), SectorSize - sizeof(SectorHeader))) {
+            return; // Already a spare
+        }
+
+        // Copy forward what the rest of the journal doesn't already supersede.
+        // Records for cleared faults can simply go: every older record for the
+        // same code lives in this (the oldest) sector too.
+        auto latest = latestRecords();
+        std::vector<Record> keep;
+        for (size_t i = 0; i < RecordsPerSector; i++) {
+            const Record& rec = slot(sector, i);
+            if (isValid(rec) && rec.active && latest[rec.code] == &rec) keep.push_back(rec);
+        }
+
+        // Normal case: the active sector has room (a compaction started from
+        // openNextSector() always has a freshly opened one), so the appends
+        // never open another sector
+        if (keep.size() <= RecordsPerSector - nextSlot) {
+            for (const Record& rec : keep) append(rec);
+            erase(sector);
+            return;
+        }
+
+        // Only mount-time recovery gets here: the active sector had filled up
+        // further before the interrupted compaction. Moving on would program
+        // this very sector, which isn't erased, and lose the records. With no
+        // erased sector left, the records are held in RAM while this one is
+        // erased and opened as the active sector, then written back to it
+        // (one sector's records always fit an empty one). A power loss in
+        // that window loses them. The next sector is now the oldest and has
+        // to become the spare in turn.
+        std::cerr << "[FlashMemory] Warning: no room to compact sector " << sector << " into sector "
+                  << activeSector << ", rewriting it in place\n";
+        erase(sector);
+        activeSector = sector;
+        nextSlot = 0;
+        uint32_t gen = nextGeneration++;
+        program(activeSector * SectorSize + offsetof(SectorHeader, generation), &gen, sizeof(gen));
+        for (const Record& rec : keep) append(rec);
+
+        sector = (sector + 1) % SectorCount;
+    }
+    std::cerr << "[FlashMemory] Error: journal too full to free a spare sector\n";
+}
+
+std::unordered_map<DTCCode, const FlashMemory::Record*> FlashMemory::latestRecords() const {
+    std::unordered_map<DTCCode, const Record*> latest;
+    for (size_t s = 0; s < SectorCount; s++) {
+        if (header(s).magic != SectorMagic) continue;
+        for (size_t i = 0; i < RecordsPerSector; i++) {
+            const Record& rec = slot(s, i);
+            if (!isValid(rec)) continue;
+            const Record*& best = latest[rec.code];
+            if (!best || rec.sequence > best->sequence) best = &rec;
         }
     }
+    return latest;
+}
+
+std::vector<DTC> FlashMemory::loadDTCs() const {
+    std::lock_guard<std::mutex> lock(flashMutex);
+
+    std::vector<const Record*> active;
+    for (const auto& entry : latestRecords()) {
+        if (entry.second->active) active.push_back(entry.second);
+    }
+    // Restore in the order the faults were set
+    std::sort(active.begin(), active.end(), [](const Record* a, const Record* b) { return a->sequence < b->sequence; });
+
+    std::vector<DTC> loadedFaults;
+    for (const Record* rec : active) {
+        loadedFaults.push_back({ rec->code, std::string(rec->message, rec->messageLength), true });
+        std::cout << "[FlashMemory] Restored stored fault: " << dtcToString(rec->code) << "\n";
+    }
     return loadedFaults;
 }
 
+// --- Commit thread ---
+
+bool FlashMemory::commitDTC(DTCCode code, bool active, const std::string& message) {
+    if (!running.load(std::memory_order_relaxed)) return false;
+
+    Record rec{};
+    rec.code = code;
+    rec.active = active ? 1 : 0;
+    rec.messageLength = static_cast<uint8_t>(std::min(message.size(), MessageSize));
+    std::memcpy(rec.message, message.data(), rec.messageLength);
+
+    if (!queue.tryPush(rec)) {
+        droppedCount.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    queuedCount.fetch_add(1, std::memory_order_release);
+
+    // State changes are rare, so commit promptly rather than on the next nap
+    wake.notify_one();
+    return true;
+}
+
+void FlashMemory::sync() {
+    uint64_t target = queuedCount.load(std::memory_order_acquire);
+    std::unique_lock<std::mutex> lock(wakeMutex);
+    committed.wait(lock, [&] {
+        return committedCount.load(std::memory_order_acquire) >= target || !running.load();
+    });
+}
+
+void FlashMemory::writerLoop() {
+    for (;;) {
+        bool stopping = !running.load();
+        size_t written = 0;
+        Record rec;
+
+        while (queue.tryPop(rec)) {
+            std::lock_guard<std::mutex> lock(flashMutex);
+            append(rec);
+            written++;
+        }
+
+        if (written > 0) {
+            {
+                std::lock_guard<std::mutex> lock(wakeMutex);
+                committedCount.fetch_add(written, std::memory_order_release);
+            }
+            committed.notify_all();
+            continue;
+        }
+        if (stopping) break; // Queue fully drained after shutdown was requested
+
+        std::unique_lock<std::mutex> lock(wakeMutex);
+        wake.wait_for(lock, std::chrono::milliseconds(100), [this] { return !running.load(); });
+    }
+    committed.notify_all();
+}
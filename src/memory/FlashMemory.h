@@ -1,17 +1,136 @@
 #pragma once
 #include <vector>
+#include <unordered_map>
 #include <string>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include "../common/RingBuffer.h"
+#include "../common/MappedFile.h"
+#include "FlashLayout.h"
 #include "../dtc/DTC.h" // We need to know what a DTC looks like
 
+// Emulated NOR flash chip, kept as a memory-mapped image file split into the
+// partitions described in FlashLayout.h. Mounting is a single mmap: the
+// journal is read and written through pointers into the mapping.
+//
+// The DTC partition holds an append-only journal of SectorCount sectors of
+// SectorSize bytes. As on real flash, a byte can be programmed only once after
+// its sector is erased (erased = 0xFF), and erasing works on whole sectors and
+// wears them, so each sector header keeps an erase counter.
+//
+// Every DTC state change is one CRC-protected record appended to the active
+// sector. Loading replays the journal in sequence order; a record torn by a
+// crash fails its CRC and is ignored, so a crash costs at most the change
+// being written. When the active sector is full the journal moves to the next
+// one (kept erased as a spare) and compacts the oldest: records that are
+// still current are copied forward, then that sector is erased and becomes
+// the new spare. Sectors are used round-robin, which spreads wear evenly.
 class FlashMemory {
 public:
-    // Save the list of active faults to a file
-    static void saveDTCs(const std::vector<DTC>& faults);
+    static constexpr size_t SectorSize = FlashLayout::SectorSize;
+    static constexpr size_t SectorCount = FlashLayout::entry(FlashLayout::Partition::DtcJournal).size / SectorSize;
+    static constexpr size_t MessageSize = 52;
 
-    // Load faults from the file at startup
-    static std::vector<DTC> loadDTCs();
+    // First 64 bytes of each sector
+    struct SectorHeader {
+        uint32_t magic;
+        uint32_t eraseCount;
+        uint32_t generation;        // 0xFFFFFFFF while the sector is a spare
+        uint8_t reserved[52];
+    };
+
+    // One DTC state change (64 bytes)
+    struct Record {
+        uint32_t sequence;
+        uint16_t code;
+        uint8_t active;
+        uint8_t messageLength;
+        char message[MessageSize];  // Truncated to fit
+        uint32_t crc;               // CRC-32 of everything above
+    };
+
+    static constexpr size_t RecordsPerSector = (SectorSize - sizeof(SectorHeader)) / sizeof(Record);
+
+    // Map the image (formatting it if missing or its partition table is not
+    // ours) and start the commit thread. A fresh image imports the old
+    // ecu_nvram.txt if present.
+    explicit FlashMemory(const std::string& filename = "ecu_flash.img");
+
+    // Commits everything still queued
+    ~FlashMemory();
+
+    FlashMemory(const FlashMemory&) = delete;
+    FlashMemory& operator=(const FlashMemory&) = delete;
+
+    // Replay the journal: every fault whose last committed state is active
+    std::vector<DTC> loadDTCs() const;
+
+    // Queue one DTC state change. Copies a fixed-size record and returns; the
+    // flash writes happen on the commit thread. Never blocks on I/O.
+    bool commitDTC(DTCCode code, bool active, const std::string& message);
+
+    // Wait until everything queued so far has been written
+    void sync();
+
+    // Times a sector has been erased (wear)
+    uint32_t getEraseCount(size_t sector) const;
+
+    // Changes lost because the commit queue was full
+    uint64_t getDroppedCount() const { return droppedCount.load(std::memory_order_relaxed); }
+
+    // Raw access to the other partitions of the same chip (freeze frames,
+    // calibration). Null if the image isn't mapped. Each partition's user does
+    // its own locking; flushPartition() writes a range back to the image file.
+    uint8_t* getPartition(FlashLayout::Partition partition);
+    size_t getPartitionSize(FlashLayout::Partition partition) const;
+    bool flushPartition(FlashLayout::Partition partition, size_t offset, size_t count);
 
 private:
-    static const std::string FILENAME;
-};
+    static constexpr size_t QueueCapacity = 256;
+
+    // --- Image ---
+    bool mapImage();        // Returns true if the image was (re)formatted
+
+    // --- Emulated chip, journal partition (caller holds flashMutex) ---
+    bool program(size_t offset, const void* bytes, size_t count);
+    void erase(size_t sector);
+    const SectorHeader& header(size_t sector) const;
+    const Record& slot(size_t sector, size_t index) const;
+    bool isErased(size_t offset, size_t count) const;
+
+    // --- Journal (commit thread, or constructor before it starts) ---
+    void mount();
+    void format();
+    void importText(const std::string& filename);
+    void append(Record rec);
+    void openNextSector();
+    void compact(size_t sector);
+    bool isValid(const Record& rec) const;
+    std::unordered_map<DTCCode, const Record*> latestRecords() const;
 
+    void writerLoop();
+
+    std::string filename;
+    MappedFile image;
+    uint8_t* journal = nullptr;     // Start of the DTC partition inside the mapping
+
+    size_t activeSector = 0;
+    size_t nextSlot = 0;
+    uint32_t nextSequence = 0;
+    uint32_t nextGeneration = 0;
+
+    RingBuffer<Record, QueueCapacity> queue;
+    std::atomic<uint64_t> droppedCount{0};
+    std::atomic<uint64_t> queuedCount{0};
+    std::atomic<uint64_t> committedCount{0};
+
+    mutable std::mutex flashMutex;  // Guards the journal between the commit thread and readers
+    std::atomic<bool> running{false};
+    std::mutex wakeMutex;
+    std::condition_variable wake;
+    std::condition_variable committed;
+    std::thread writer;
+};
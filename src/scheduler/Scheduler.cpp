@@ -1,27 +1,171 @@
 #include "Scheduler.h"
 #include <thread>
+#include <algorithm>
 
-void Scheduler::addTask(std::function<void()> task, int intervalMs) {
-    tasks.push_back({task, intervalMs, std::chrono::steady_clock::now()});
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+constexpr std::chrono::milliseconds Scheduler::LateThreshold;
+
+// Pin the calling worker to one core and raise it to a real-time priority
+// matching its band. Both are best effort: without the privileges for
+// SCHED_FIFO the band still runs, just at normal OS priority.
+static void configureBandThread(size_t band) {
+    unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    unsigned core = static_cast<unsigned>(band % cores);
+
+#ifdef _WIN32
+    SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << core);
+    static const int winPriority[Scheduler::BandCount] = {
+        THREAD_PRIORITY_TIME_CRITICAL, THREAD_PRIORITY_ABOVE_NORMAL, THREAD_PRIORITY_NORMAL
+    };
+    SetThreadPriority(GetCurrentThread(), winPriority[band]);
+#elif defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(core, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+
+    sched_param param{};
+    param.sched_priority = sched_get_priority_max(SCHED_FIFO) - static_cast<int>(band) * 10;
+    pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+#else
+    (void)core;
+#endif
+}
+
+Scheduler::Scheduler(ClockMode mode)
+    : mode(mode), startTime(std::chrono::steady_clock::now()) {}
+
+size_t Scheduler::addTask(std::function<void()> task, int intervalMs, Priority priority) {
+    Duration interval = std::chrono::milliseconds(intervalMs);
+    size_t id = tasks.size();
+
+    tasks.emplace_back(std::move(task), interval, elapsed() + interval);
+    bands[static_cast<size_t>(priority)].push({tasks[id].nextRun, id});
+    return id;
+}
+
+Scheduler::TaskStats Scheduler::getTaskStats(size_t taskId) const {
+    const Task& t = tasks[taskId];
+    TaskStats stats;
+    stats.activations = t.activations.load(std::memory_order_relaxed);
+    stats.late = t.late.load(std::memory_order_relaxed);
+    stats.missed = t.missed.load(std::memory_order_relaxed);
+    stats.worstLatency = std::chrono::microseconds(t.worstLatencyUs.load(std::memory_order_relaxed));
+    return stats;
+}
+
+Scheduler::Duration Scheduler::elapsed() const {
+    if (mode == ClockMode::Virtual) {
+        return virtualNow;
+    }
+    return std::chrono::steady_clock::now() - startTime;
+}
+
+std::chrono::milliseconds Scheduler::now() const {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(elapsed());
 }
 
 void Scheduler::run() {
-    while (true) {
+    runUntil(Duration::max());
+}
+
+void Scheduler::runFor(std::chrono::milliseconds duration) {
+    runUntil(elapsed() + duration);
+}
+
+void Scheduler::stop() {
+    stopRequested = true;
+}
 
-        auto now = std::chrono::steady_clock::now();
+void Scheduler::waitUntil(Duration deadline) {
+    if (mode == ClockMode::Virtual) {
+        // Nothing happens between deadlines, so jump straight to the next one
+        virtualNow = std::max(virtualNow, deadline);
+    } else {
+        std::this_thread::sleep_until(startTime + deadline);
+    }
+}
+
+void Scheduler::runUntil(Duration endTime) {
+    std::vector<size_t> active;
+    for (size_t b = 0; b < BandCount; b++) {
+        if (!bands[b].empty()) active.push_back(b);
+    }
+
+    // A single band, or virtual time, runs on the calling thread
+    if (mode == ClockMode::Virtual || active.size() <= 1) {
+        runBands(active, endTime);
+        return;
+    }
 
-        for (auto& t : tasks) {
+    // Rate-monotonic executor: one pinned worker per band
+    std::vector<std::thread> workers;
+    for (size_t b : active) {
+        workers.emplace_back([this, b, endTime]() {
+            configureBandThread(b);
+            runBands({ b }, endTime);
+        });
+    }
+    for (auto& w : workers) w.join();
+}
 
-            auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
-                now - t.lastRun
-            ).count();
+void Scheduler::runBands(const std::vector<size_t>& bandIds, Duration endTime) {
+    while (!stopRequested) {
+
+        // Earliest deadline across the given bands (higher band wins a tie)
+        TimerQueue* queue = nullptr;
+        for (size_t b : bandIds) {
+            if (bands[b].empty()) continue;
+            if (!queue || queue->top().deadline > bands[b].top().deadline) queue = &bands[b];
+        }
+        if (!queue) break;
 
-            if (elapsed >= t.intervalMs) {
-                t.func();               // Run the task
-                t.lastRun = now;        // Reset timer
-            }
+        Activation next = queue->top();
+        if (next.deadline >= endTime) {
+            waitUntil(endTime);
+            break;
         }
 
-        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        // Sleep until the earliest deadline instead of polling every task
+        waitUntil(next.deadline);
+        queue->pop();
+
+        dispatch(next.taskId);
+        queue->push({tasks[next.taskId].nextRun, next.taskId});
+    }
+}
+
+void Scheduler::dispatch(size_t taskId) {
+    Task& t = tasks[taskId];
+
+    auto latency = std::chrono::duration_cast<std::chrono::microseconds>(elapsed() - t.nextRun).count();
+    t.activations.fetch_add(1, std::memory_order_relaxed);
+    if (latency > t.worstLatencyUs.load(std::memory_order_relaxed)) {
+        t.worstLatencyUs.store(latency, std::memory_order_relaxed);
+    }
+    if (latency >= std::chrono::microseconds(LateThreshold).count()) {
+        t.late.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    t.func();   // Run the task
+
+    // Drift-free period: the next deadline is relative to the last deadline,
+    // not to when the task happened to run
+    t.nextRun += t.interval;
+
+    // Overrun: if whole periods have already gone by, skip them (counted as
+    // missed) and run once, late, rather than firing a burst of catch-up calls
+    auto finished = elapsed();
+    if (t.interval > Duration::zero() && t.nextRun < finished) {
+        auto behind = (finished - t.nextRun) / t.interval;
+        t.missed.fetch_add(static_cast<uint64_t>(behind), std::memory_order_relaxed);
+        t.nextRun += behind * t.interval;
     }
 }
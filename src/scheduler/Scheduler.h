@@ -1,19 +1,108 @@
     #pragma once
+    #include <array>
+    #include <deque>
     #include <vector>
+    #include <queue>
     #include <functional>
     #include <chrono>
+    #include <atomic>
+    #include <cstdint>
+    #include <cstddef>
 
     class Scheduler {
     public:
-        void addTask(std::function<void()> task, int intervalMs);
+        // RealTime: tasks follow the wall clock (steady_clock), as on the target.
+        // Virtual:  the scheduler owns the time base and jumps straight to the
+        //           next due task, so simulated time runs as fast as the CPU allows.
+        enum class ClockMode { RealTime, Virtual };
+
+        // Priority bands. In RealTime mode every band that has tasks gets its own
+        // worker thread, pinned to its own core, so a slow Low task can never
+        // delay a High one. Tasks in different bands then run concurrently and
+        // must not share unprotected state.
+        // In Virtual mode all bands run on the calling thread (High first on a
+        // tie) to keep runs repeatable.
+        enum class Priority { High = 0, Normal, Low };
+        static constexpr size_t BandCount = 3;
+
+        // Per-task activation counters
+        struct TaskStats {
+            uint64_t activations = 0;   // Times the task actually ran
+            uint64_t late = 0;          // Runs that started at least LateThreshold after their deadline
+            uint64_t missed = 0;        // Deadlines skipped because a whole period had already passed
+            std::chrono::microseconds worstLatency{0};
+        };
+
+        // Start latency at which an activation counts as late
+        static constexpr std::chrono::milliseconds LateThreshold{1};
+
+        explicit Scheduler(ClockMode mode = ClockMode::RealTime);
+
+        // Register tasks before calling run(). Returns an id for getTaskStats().
+        size_t addTask(std::function<void()> task, int intervalMs, Priority priority = Priority::Normal);
+
+        // Run until stop() is called (from a task or another thread)
         void run();
 
+        // Run for a span of scheduler time, then return
+        void runFor(std::chrono::milliseconds duration);
+
+        // Makes run()/runFor() return. Sticky: a stop() issued before run()
+        // (e.g. a signal during setup) makes it return at once, and the
+        // scheduler stays stopped until reset().
+        void stop();
+        void reset() { stopRequested = false; }
+
+        // Scheduler time elapsed since construction (virtual or real)
+        std::chrono::milliseconds now() const;
+
+        ClockMode getClockMode() const { return mode; }
+
+        // Safe to call from any thread while the scheduler is running
+        TaskStats getTaskStats(size_t taskId) const;
+
     private:
+        using Duration = std::chrono::steady_clock::duration;
+
         struct Task {
+            Task(std::function<void()> func, Duration interval, Duration nextRun)
+                : func(std::move(func)), interval(interval), nextRun(nextRun) {}
+
             std::function<void()> func;
-            int intervalMs;
-            std::chrono::steady_clock::time_point lastRun;
+            Duration interval;
+            Duration nextRun;           // Absolute deadline, advanced by exactly one interval per period
+
+            // Written by the band's worker, read by getTaskStats() from anywhere
+            std::atomic<uint64_t> activations{0};
+            std::atomic<uint64_t> late{0};
+            std::atomic<uint64_t> missed{0};
+            std::atomic<int64_t> worstLatencyUs{0};
         };
 
-        std::vector<Task> tasks;
+        // One pending deadline in a timer queue
+        struct Activation {
+            Duration deadline;
+            size_t taskId;
+
+            // Ties resolve in registration order, so a virtual run is repeatable
+            bool operator>(const Activation& other) const {
+                if (deadline != other.deadline) return deadline > other.deadline;
+                return taskId > other.taskId;
+            }
+        };
+
+        using TimerQueue = std::priority_queue<Activation, std::vector<Activation>, std::greater<Activation>>;
+
+        Duration elapsed() const;
+        void runUntil(Duration endTime);
+        void runBands(const std::vector<size_t>& bandIds, Duration endTime);
+        void waitUntil(Duration deadline);
+        void dispatch(size_t taskId);
+
+        std::deque<Task> tasks;                     // deque: tasks never move once added
+        std::array<TimerQueue, BandCount> bands;    // One deadline queue per priority band
+        ClockMode mode;
+        std::chrono::steady_clock::time_point startTime;
+        Duration virtualNow{0};
+        std::atomic<bool> stopRequested{false};
     };
@@ -1,22 +1,11 @@
 #include "SensorModule.h"
-#include "../Filters/Filter.h"   // <-- Include filtering functions
+#include <algorithm>
 
-#include <random>
-#include <chrono>
-
-LowPassFilter rpmFilter(0.15f);
-LowPassFilter throttleFilter(0.20f);
-LowPassFilter coolantFilter(0.10f);
-
-SensorModule::SensorModule()
-    : lastRPM(800), lastThrottle(20), lastCoolant(90) {}
+SensorModule::SensorModule(uint64_t seed)
+    : rng(seed), lastRPM(800), lastThrottle(20), lastCoolant(90) {}
 
 float SensorModule::randFloat(float min, float max) {
-    static std::mt19937 rng(
-        std::chrono::system_clock::now().time_since_epoch().count()
-    );
-    std::uniform_real_distribution<float> dist(min, max);
-    return dist(rng);
+    return rng.uniform(min, max);
 }
 
 // ... existing includes ...
@@ -40,12 +29,54 @@ int SensorModule::getRPM() {
 //     return rpmFilter.apply(raw);
 // }
 
+void SensorModule::attachReplay(SensorReplay* source) {
+    replay = (source && source->isOpen()) ? source : nullptr;
+    if (replay) setTime(0.0);
+}
+
+void SensorModule::setTime(double seconds) {
+    if (replay) replayValues = replay->sample(seconds);
+}
+
+float SensorModule::getIntakeTemp() {
+    return replay ? replayValues[SensorRecording::IntakeTemp] : 30.0f;
+}
+
+float SensorModule::getLoad() {
+    return replay ? replayValues[SensorRecording::Load] : 0.0f;
+}
+
 float SensorModule::getThrottle() {
+    if (replay) return replayValues[SensorRecording::Throttle];
     float raw = randFloat(0, 100);
     return throttleFilter.apply(raw);
 }
 
 float SensorModule::getCoolantTemp() {
+    if (replay) return replayValues[SensorRecording::Coolant];
     float raw = randFloat(80, 100);
     return coolantFilter.apply(raw);
+}
+
+void SensorModule::fillThrottle(float* out, size_t count) {
+    if (replay) {
+        std::fill(out, out + count, replayValues[SensorRecording::Throttle]);
+        return;
+    }
+    fillFiltered(throttleFilter, 0, 100, out, count);
+}
+
+void SensorModule::fillCoolantTemp(float* out, size_t count) {
+    if (replay) {
+        std::fill(out, out + count, replayValues[SensorRecording::Coolant]);
+        return;
+    }
+    fillFiltered(coolantFilter, 80, 100, out, count);
+}
+
+void SensorModule::fillFiltered(LowPassFilter& filter, float min, float max, float* out, size_t count) {
+    // Raw noise for the whole block first (a tight loop with no dependencies
+    // on the filter), then the filter, which is sequential by nature
+    for (size_t i = 0; i < count; i++) out[i] = randFloat(min, max);
+    filter.process(Span<const float>(out, count), Span<float>(out, count));
 }
\ No newline at end of file
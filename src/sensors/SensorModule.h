@@ -1,8 +1,15 @@
 #pragma once
+#include <cstddef>
+#include <cstdint>
+#include "../Filters/Filter.h"
+#include "../common/FastRandom.h"
+#include "SensorReplay.h"
 
 class SensorModule {
 public:
-    SensorModule();
+    // All noise comes from this instance's own generator: the same seed gives
+    // the same readings, and modules on different threads don't interfere
+    explicit SensorModule(uint64_t seed = DefaultSeed);
 
     int getRPM();            // Returns the stored RPM (with noise)
     float getThrottle();     
@@ -11,8 +18,37 @@ public:
     // NEW: Allow the Physics Engine to update the real RPM
     void setSimulatedRPM(int rpm);
 
+    // Recorded channels instead of simulated noise: with a replay attached,
+    // throttle, coolant, intake air temperature and load come from the
+    // recording at the time last given to setTime(). RPM still follows the
+    // physics engine. Pass nullptr to go back to simulation.
+    void attachReplay(SensorReplay* source);
+    bool isReplaying() const { return replay != nullptr; }
+    void setTime(double seconds);
+
+    float getIntakeTemp();   // Recorded, or a fixed 30 C when simulating
+    float getLoad();         // Recorded load (Nm), 0 when simulating
+
+    // Bulk versions: the next `count` readings in one go, exactly what the
+    // same number of single calls would return
+    void fillThrottle(float* out, size_t count);
+    void fillCoolantTemp(float* out, size_t count);
+
+    static constexpr uint64_t DefaultSeed = 0x5EED;
+
 private:
     float randFloat(float min, float max);
+    void fillFiltered(LowPassFilter& filter, float min, float max, float* out, size_t count);
+
+    FastRandom rng;
+
+    SensorReplay* replay = nullptr;
+    SensorReplay::Values replayValues{};   // Sampled once per setTime()
+
+    // Per-instance filter state
+    LowPassFilter rpmFilter{0.15f};
+    LowPassFilter throttleFilter{0.20f};
+    LowPassFilter coolantFilter{0.10f};
 
     // Last filtered values
     float lastRPM;
@@ -21,4 +57,4 @@ private:
 };
 // Simulated Sensor Module
 // Provides noisy readings for RPM, Throttle Position, Coolant Temp
-// NEW: Allows external setting of RPM to sync with physics engine
\ No newline at end of file
+// NEW: Allows external setting of RPM to sync with physics engine
@@ -0,0 +1,124 @@
+#include "SensorReplay.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+using namespace SensorRecording;
+
+bool SensorReplay::open(const std::string& path) {
+    close();
+    if (!file.open(path, MappedFile::Mode::ReadOnly)) return false;
+
+    if (file.size() < sizeof(FileHeader)) {
+        std::cerr << "[SensorReplay] Error: " << path << " is too small to be a recording\n";
+        close();
+        return false;
+    }
+
+    FileHeader header;
+    std::memcpy(&header, file.data(), sizeof(header));
+    if (std::memcmp(header.magic, Magic, sizeof(Magic)) != 0 || header.version != Version ||
+        header.channelCount != ChannelCount) {
+        std::cerr << "[SensorReplay] Error: " << path << " is not a version " << Version << " recording\n";
+        close();
+        return false;
+    }
+
+    if (header.frameCount == 0 || header.frameCount > (file.size() - sizeof(FileHeader)) / sizeof(Frame)) {
+        std::cerr << "[SensorReplay] Error: " << path << " is empty or truncated\n";
+        close();
+        return false;
+    }
+
+    frames = reinterpret_cast<const Frame*>(file.data() + sizeof(FileHeader));
+    count = static_cast<size_t>(header.frameCount);
+    cursor = 0;
+    prefetchedUntil = releasedUntil = sizeof(FileHeader);
+    file.adviseSequential();
+    updateResidency();
+    return true;
+}
+
+void SensorReplay::close() {
+    file.close();
+    frames = nullptr;
+    count = 0;
+    cursor = 0;
+}
+
+double SensorReplay::getDuration() const {
+    return count ? frames[count - 1].time - frames[0].time : 0.0;
+}
+
+SensorReplay::Values SensorReplay::sample(double seconds) {
+    Values out{};
+    if (!frames) return out;
+
+    double duration = getDuration();
+    if (loop && duration > 0.0 && seconds >= duration) seconds = std::fmod(seconds, duration);
+    double t = frames[0].time + seconds;
+
+    size_t i = locate(t);
+    updateResidency();
+
+    const Frame& a = frames[i];
+    if (i + 1 >= count || t <= a.time) {
+        std::copy(std::begin(a.values), std::end(a.values), out.begin());
+        return out;
+    }
+
+    const Frame& b = frames[i + 1];
+    float frac = static_cast<float>((t - a.time) / (b.time - a.time));
+    for (size_t ch = 0; ch < ChannelCount; ch++) {
+        out[ch] = a.values[ch] + frac * (b.values[ch] - a.values[ch]);
+    }
+    return out;
+}
+
+// Last frame at or before `time` (0 if before the first)
+size_t SensorReplay::locate(double time) {
+    auto byTime = [](double t, const Frame& f) { return t < f.time; };
+
+    size_t i = cursor;
+    if (frames[i].time <= time) {
+        // Playback moves forward a frame or two per call: walk a few steps
+        // before resorting to a search of the rest of the file
+        for (int step = 0; step < 8; step++) {
+            if (i + 1 >= count || frames[i + 1].time > time) {
+                cursor = i;
+                return i;
+            }
+            i++;
+        }
+        i = static_cast<size_t>(std::upper_bound(frames + i, frames + count, time, byTime) - frames) - 1;
+    } else {
+        const Frame* next = std::upper_bound(frames, frames + i, time, byTime);
+        i = next == frames ? 0 : static_cast<size_t>(next - frames) - 1;
+    }
+
+    cursor = i;
+    return i;
+}
+
+// Keep a window of the file resident ahead of the cursor and let go of what
+// playback has passed
+void SensorReplay::updateResidency() {
+    size_t pos = sizeof(FileHeader) + cursor * sizeof(Frame);
+
+    // A jump outside the tracked window starts a new one
+    if (pos < releasedUntil || pos > prefetchedUntil) {
+        releasedUntil = prefetchedUntil = pos;
+    }
+
+    if (prefetchedUntil - pos < PrefetchBytes / 2) {
+        file.prefetch(prefetchedUntil, PrefetchBytes);
+        prefetchedUntil += PrefetchBytes;
+    }
+
+    if (pos - releasedUntil > 2 * PrefetchBytes) {
+        size_t keepFrom = pos - PrefetchBytes;
+        file.release(releasedUntil, keepFrom - releasedUntil);
+        releasedUntil = keepFrom;
+    }
+}
@@ -0,0 +1,82 @@
+#pragma once
+#include <array>
+#include <string>
+#include <cstddef>
+#include <cstdint>
+#include "../common/MappedFile.h"
+
+// Recorded sensor channels (.erc), as written by ecu_replay_convert
+//
+//   [FileHeader] [Frame]...
+//
+// Fixed-size frames sorted by strictly increasing time, so any instant is
+// found by index arithmetic or a short search, and the file is read straight
+// from the mapping with no decoding.
+namespace SensorRecording {
+
+enum Channel : uint32_t { Throttle = 0, Coolant, IntakeTemp, Load, ChannelCount };
+
+struct FileHeader {
+    char magic[8];              // "ECUREC\0\0"
+    uint32_t version;
+    uint32_t channelCount;      // ChannelCount
+    uint64_t frameCount;
+    double startTime;           // Seconds, time of the first frame
+    double endTime;             // Seconds, time of the last frame
+    uint8_t reserved[24];
+};
+
+struct Frame {
+    double time;                // Seconds
+    float values[ChannelCount]; // Throttle %, coolant C, intake air C, load Nm
+};
+
+static_assert(sizeof(FileHeader) == 64, "FileHeader layout is part of the file format");
+static_assert(sizeof(Frame) == 24, "Frame layout is part of the file format");
+
+constexpr uint32_t Version = 1;
+constexpr char Magic[8] = { 'E', 'C', 'U', 'R', 'E', 'C', 0, 0 };
+
+} // namespace SensorRecording
+
+// Plays a recording back as sensor readings. The file is memory-mapped and
+// only the pages around the playback position are resident: a window ahead is
+// prefetched as playback moves, and pages left behind are released, so a
+// multi-gigabyte recording costs a few megabytes of RAM.
+//
+// Playback is normally monotonic (the scheduler's clock), so sample() starts
+// from the frame it used last and steps forward; a jump (seek, loop) falls
+// back to a binary search. Not thread-safe: one reader at a time.
+class SensorReplay {
+public:
+    using Values = std::array<float, SensorRecording::ChannelCount>;
+
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return frames != nullptr; }
+
+    // All channels at `seconds` after the start of the recording, linearly
+    // interpolated between frames. Past the end the last frame is held, or
+    // playback wraps around if looping is on.
+    Values sample(double seconds);
+
+    void setLoop(bool enabled) { loop = enabled; }
+
+    size_t getFrameCount() const { return count; }
+    double getDuration() const;
+
+    // Bytes ahead of the playback position kept prefetched
+    static constexpr size_t PrefetchBytes = 4 << 20;
+
+private:
+    size_t locate(double time);
+    void updateResidency();
+
+    MappedFile file;
+    const SensorRecording::Frame* frames = nullptr;
+    size_t count = 0;
+    size_t cursor = 0;              // Frame used by the last sample()
+    size_t prefetchedUntil = 0;     // File offset the prefetch window reaches
+    size_t releasedUntil = 0;       // File offset below which pages were released
+    bool loop = false;
+};
@@ -0,0 +1,368 @@
+#include "EcuTasks.h"
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+
+#include "../scheduler/Scheduler.h"
+#include "../sensors/SensorModule.h"
+#include "../engine/FuelControl.h"
+#include "../engine/CrankEngine.h"
+#include "../dtc/DTCManager.h"
+#include "../dtc/FreezeFrame.h"
+#include "../can/CANBus.h"
+#include "../can/SocketCANBackend.h"
+#include "../can/CANTrace.h"
+#include "../can/EcuSignals.h"
+#include "../logging/Logger.h"
+
+EcuConfig EcuConfig::fromEnvironment() {
+    EcuConfig config;
+
+    // Sensor noise seed: fixed by default, so two runs are identical;
+    // ECU_SEED=<n> picks another, ECU_SEED=time a different one every run
+    if (const char* seedEnv = std::getenv("ECU_SEED")) {
+        config.seed = std::string(seedEnv) == "time"
+            ? static_cast<uint64_t>(std::chrono::system_clock::now().time_since_epoch().count())
+            : std::strtoull(seedEnv, nullptr, 10);
+    }
+
+    // ECU_CLOCK=virtual runs the task set on simulated time, as fast as the CPU allows
+    const char* clockEnv = std::getenv("ECU_CLOCK");
+    config.virtualClock = clockEnv && std::string(clockEnv) == "virtual";
+
+    // ECU_LOG_FORMAT=binary writes the compact indexed format instead of CSV
+    const char* logFormatEnv = std::getenv("ECU_LOG_FORMAT");
+    config.binaryLog = logFormatEnv && std::string(logFormatEnv) == "binary";
+    config.logFile = config.binaryLog ? "ecu_log.ecb" : "ecu_log.csv";
+
+    // ECU_REPLAY=<file.erc> plays recorded throttle, coolant, intake air and
+    // load back instead (convert a CSV with ecu_replay_convert)
+    if (const char* replayPath = std::getenv("ECU_REPLAY")) config.sensorReplay = replayPath;
+
+    if (const char* canIf = std::getenv("ECU_CAN_IF")) config.canInterface = canIf;
+    if (const char* recordPath = std::getenv("ECU_CAN_RECORD")) config.canRecord = recordPath;
+    if (const char* replayPath = std::getenv("ECU_CAN_REPLAY")) config.canReplay = replayPath;
+    if (const char* speed = std::getenv("ECU_CAN_REPLAY_SPEED")) config.canReplaySpeed = std::atof(speed);
+    return config;
+}
+
+static std::vector<DTC> activeFaults(const DTCManager& dtc) {
+    std::vector<DTC> active;
+    for (const auto& f : dtc.getFaultsSnapshot()) {
+        if (f.active) active.push_back(f);
+    }
+    return active;
+}
+
+EcuSummary runEcu(const EcuConfig& config, ECUState& ecuState, const std::atomic<bool>& running) {
+    if (config.console) std::cout << "[ECU] Sensor noise seed: " << config.seed << "\n";
+    SensorModule sensors(config.seed);
+
+    SensorReplay replay;
+    if (!config.sensorReplay.empty() && replay.open(config.sensorReplay)) {
+        sensors.attachReplay(&replay);
+        if (config.console) std::cout << "[ECU] Replaying " << config.sensorReplay << " (" << replay.getDuration() << " s)\n";
+    }
+
+    FuelControl fuel;
+    DTCManager dtc(config.flashImage);
+    CANBus canBus;
+    CrankEngine engine;     // EnginePhysics resolved into per-cylinder crank-angle events
+
+    std::unique_ptr<Logger> logger;
+    if (!config.logFile.empty()) {
+        logger = std::make_unique<Logger>(config.logFile, config.binaryLog ? Logger::Format::Binary : Logger::Format::Csv);
+    }
+
+    Scheduler scheduler(config.virtualClock ? Scheduler::ClockMode::Virtual : Scheduler::ClockMode::RealTime);
+    if (config.virtualClock) {
+        // Stamp CAN frames with simulated time too
+        canBus.setClock([&]() { return std::chrono::steady_clock::time_point(scheduler.now()); });
+    }
+    std::vector<size_t> taskIds;
+
+    // Engine load: the scenario's profile plus whatever the TCU asks for, or
+    // the recorded load when replaying sensors
+    float currentLoad = 0.0f;
+    float tcuLoad = 0.0f;
+    size_t profileStep = 0;
+    auto profileLoad = [&](double t) {
+        const auto& steps = config.loadProfile;
+        while (profileStep + 1 < steps.size() && steps[profileStep + 1].time <= t) profileStep++;
+        return (steps.empty() || steps[profileStep].time > t) ? 0.0f : steps[profileStep].load;
+    };
+
+    // Monitors register their codes once; the hot path only flips bits
+    constexpr DTCCode P0217 = makeDTC("P0217");
+    dtc.registerFault(P0217, "Engine Overheat");
+    const std::vector<DTC> faultsAtStart = activeFaults(dtc);
+
+    // Snapshot history at the physics rate; a newly set fault freezes the
+    // window around it into the flash image
+    FreezeFrameRecorder freezeFrames(dtc.getFlash(), 10);
+    dtc.setActivationHook([&](DTCCode code) { freezeFrames.trigger(code); });
+
+    EcuSummary summary;
+    summary.minRPM = 1 << 30;
+    double rpmSum = 0.0, injectionSum = 0.0;
+
+    // Priority bands (rate-monotonic): physics, control logic and CAN receive
+    // share the engine/sensor state and run in the High band. Bus I/O (TCU
+    // transmit, status broadcast, SocketCAN) runs in the Normal band, so a
+    // syscall can't hold up the physics step. Console housekeeping runs in the
+    // Low band. Normal and Low each get their own thread in real time and only
+    // touch thread-safe state: ecuState snapshots, the DTC snapshot, and the
+    // CAN bus (any thread may send).
+
+    // TASK 1: Physics (10ms)
+    taskIds.push_back(scheduler.addTask([&]() {
+        double now = std::chrono::duration<double>(scheduler.now()).count();
+        sensors.setTime(now);
+        currentLoad = sensors.isReplaying() ? sensors.getLoad() : profileLoad(now) + tcuLoad;
+
+        float throttle = sensors.getThrottle();
+        if (throttle < 1.0f && engine.getRPM() < 650) throttle = 6.0f; // Anti-stall
+        engine.update(throttle, currentLoad, 0.01f);
+        sensors.setSimulatedRPM((int)engine.getRPM());
+
+        // Freeze-frame history: latest published state with this tick's engine values
+        ECUData sample = ecuState.read();
+        sample.rpm = (int)engine.getRPM();
+        sample.throttle = throttle;
+        sample.load = currentLoad;
+        freezeFrames.record(sample);
+
+    }, 10, Scheduler::Priority::High));
+
+    // TASK 2: Logic & Shared State Update (50ms)
+    taskIds.push_back(scheduler.addTask([&]() {
+        int rpm = sensors.getRPM();
+        float throttle = sensors.getThrottle();
+        float coolant = sensors.getCoolantTemp();
+        float inj = fuel.calculateInjectionTime(rpm, throttle, sensors.getIntakeTemp());
+        engine.setInjection(inj, 300.0f); // Closed-valve injection, before the intake opens
+
+        // Get Faults
+        const char* code = "None";
+        char codeText[6];
+        DTCCode activeCode;
+        if (dtc.getFirstActive(activeCode)) {
+            formatDTC(activeCode, codeText);
+            code = codeText;
+        }
+
+        // --- UPDATE SHARED STATE FOR GUI ---
+        ecuState.update(rpm, throttle, coolant, currentLoad, inj, code);
+
+        // --- LOG TO CSV (queued; the logger's own thread does the file I/O) ---
+        double timeSec = std::chrono::duration<double>(scheduler.now()).count();
+        if (logger) logger->log(timeSec, rpm, throttle, coolant, currentLoad, inj, code);
+
+        // Fault Logic
+        if (coolant > 92.0f) dtc.addFault(P0217);
+
+        // Run statistics
+        summary.controlCycles++;
+        summary.minRPM = std::min(summary.minRPM, rpm);
+        summary.maxRPM = std::max(summary.maxRPM, rpm);
+        summary.maxCoolant = std::max(summary.maxCoolant, coolant);
+        summary.maxInjectionMs = std::max(summary.maxInjectionMs, inj);
+        rpmSum += rpm;
+        injectionSum += inj;
+        if (rpm < EcuSummary::StallRPM && summary.stallTime < 0.0) summary.stallTime = timeSec;
+
+    }, 50, Scheduler::Priority::High));
+
+    // TASK 3: Print Active Faults to Console (1000ms)
+    FreezeFrame frame; // Reused; too big for the stack of every call
+    if (config.console) {
+        taskIds.push_back(scheduler.addTask([&]() {
+            const auto faults = dtc.getFaultsSnapshot();
+
+            bool headerPrinted = false;
+
+            for (const auto& f : faults) {
+                if (f.active) {
+                    if (!headerPrinted) {
+                        std::cout << "\n!!! ACTIVE DTCs !!!\n";
+                        headerPrinted = true;
+                    }
+                    std::cout << "  CODE: " << dtcToString(f.code) << " - " << f.message << "\n";
+
+                    if (freezeFrames.getFrame(f.code, frame) && frame.preSamples > 0) {
+                        const ECUData& at = frame.samples[frame.preSamples - 1];
+                        std::cout << "    Freeze frame: RPM " << at.rpm << ", Throttle " << at.throttle
+                                  << "%, Coolant " << at.coolant << "C ("
+                                  << frame.preSamples << " samples before, " << FreezeFrame::PostSamples << " after)\n";
+                    }
+                }
+            }
+
+            if (headerPrinted) {
+                std::cout << "!!!!!!!!!!!!!!!!!!!\n\n";
+            }
+        }, 1000, Scheduler::Priority::Low));
+    }
+
+    // TASK 3.5: Freeze Frame Storage (100ms)
+    // Writes a completed capture to flash, off the control bands
+    taskIds.push_back(scheduler.addTask([&]() {
+        freezeFrames.poll();
+    }, 100, Scheduler::Priority::Low));
+
+    // TASK 4: Console Dashboard (100ms)
+    // Prints the snapshot published by Task 2, so it never touches the sensors directly
+    if (config.console) {
+        taskIds.push_back(scheduler.addTask([&]() {
+            ECUData data = ecuState.read();
+
+            // Print Dashboard
+            std::cout << std::fixed << std::setprecision(1);
+            std::cout << "RPM: " << std::setw(4) << data.rpm
+                      << " | Throttle: " << std::setw(4) << data.throttle << "%"
+                      << " | Load: " << data.load << "Nm"
+                      << " | Coolant: " << data.coolant << "C"
+                      << " | Inj: " << data.injectionMs << "ms"
+                      << "\n";
+
+        }, 100, Scheduler::Priority::Low));
+    }
+
+    // --- TASK 5: CAN Receiver (TCU Simulation) (100ms) ---
+    // Reads messages from the bus. If ID 0x200 (Transmission) asks for low torque,
+    // we simulate a high load on the engine.
+    // The acceptance filter means only 0x200 frames ever reach our queue.
+    using EcuSignals::TcuCommand;
+    CANBus::SubscriberId ecuRx = canBus.subscribe({ {TcuCommand::id, 0x7FF} });
+    std::array<CANMessage, 32> rxBuffer; // Reused every cycle, no allocation
+    taskIds.push_back(scheduler.addTask([&]() {
+        size_t count;
+        while ((count = canBus.readMessages(ecuRx, rxBuffer.data(), rxBuffer.size())) > 0) {
+            for (size_t i = 0; i < count; i++) {
+                const CANMessage& m = rxBuffer[i];
+                int torqueReq = (int)TcuCommand::TorqueRequest::decode(m.data);
+
+                // DEBUG PRINT: Show we received it
+                if (config.console) std::cout << "[CAN-RX] ID: 0x200 | TorqueReq: " << torqueReq << "Nm\n";
+
+                if (torqueReq < 100) {
+                    tcuLoad = 80.0f; // Apply "Brake" load
+                    if (config.console) std::cout << ">>> [ECU] TCU Requested Torque Reduction -> Applying Load!\n";
+                } else {
+                    tcuLoad = 0.0f;
+                }
+            }
+        }
+    }, 100, Scheduler::Priority::High));
+
+    // --- TASK 6: Transmission Simulation (3000ms) ---
+    // Simulates an external Transmission module sending commands periodically
+    bool shiftToggle = false;
+    if (config.tcu) {
+        taskIds.push_back(scheduler.addTask([&]() {
+            CANMessage msg{};
+            msg.id = TcuCommand::id;
+            msg.dlc = TcuCommand::dlc;
+            shiftToggle = !shiftToggle;
+
+            // Toggle between "Drive Normally" (200Nm) and "Shift" (50Nm)
+            int torqueReq = shiftToggle ? 200 : 50;
+            TcuCommand::TorqueRequest::encode(msg.data, torqueReq);
+            TcuCommand::Gear::encode(msg.data, 3); // Gear 3
+            canBus.sendMessage(msg);
+
+            // DEBUG PRINT: Show we sent it
+            if (config.console) std::cout << "[TCU-TX] Sending Gear Shift Command: " << torqueReq << "Nm\n";
+        }, config.tcuPeriodMs, Scheduler::Priority::Normal));
+    }
+
+    // --- TASK 7: Engine Status Broadcast (50ms) ---
+    // Packs RPM, throttle and coolant into ID 0x100 using the signal database.
+    // Sends the values Task 2 published, so it never touches the sensors from
+    // another band.
+    taskIds.push_back(scheduler.addTask([&]() {
+        using EcuSignals::EngineStatus;
+        ECUData data = ecuState.read();
+
+        CANMessage msg{};
+        msg.id = EngineStatus::id;
+        msg.dlc = EngineStatus::dlc;
+        EngineStatus::EngineSpeed::encode(msg.data, data.rpm);
+        EngineStatus::ThrottlePosition::encode(msg.data, data.throttle);
+        EngineStatus::CoolantTemp::encode(msg.data, data.coolant);
+        canBus.sendMessage(msg);
+    }, 50, Scheduler::Priority::Normal));
+
+    // --- TASK 8: External CAN (10ms) ---
+    // Mirrors the bus onto a SocketCAN interface (candump, cansniffer...)
+    if (!config.canInterface.empty()) {
+        auto socketCan = std::make_unique<SocketCANBackend>(config.canInterface);
+        if (socketCan->isOpen()) {
+            canBus.setBackend(std::move(socketCan));
+            taskIds.push_back(scheduler.addTask([&]() {
+                canBus.poll();      // sendmmsg/recvmmsg: kept off the High band
+            }, 10, Scheduler::Priority::Normal));
+        }
+    }
+
+    // --- TASK 9: CAN Trace Record / Replay (10ms) ---
+    // Record captures all bus traffic to a binary trace. Replay injects a
+    // recorded trace at canReplaySpeed (1 = recorded pace, N = N times faster,
+    // 0 = as fast as possible).
+    std::unique_ptr<CANTraceRecorder> canRecorder;
+    std::unique_ptr<CANTraceReplayer> canReplayer;
+    if (!config.canRecord.empty()) {
+        canRecorder = std::make_unique<CANTraceRecorder>(canBus, config.canRecord);
+        taskIds.push_back(scheduler.addTask([&]() {
+            canRecorder->poll();    // File writes stay out of the High band
+        }, 10, Scheduler::Priority::Normal));
+    }
+    if (!config.canReplay.empty()) {
+        canReplayer = std::make_unique<CANTraceReplayer>(canBus, config.canReplay);
+        canReplayer->setSpeed(config.canReplaySpeed);
+        auto replayStart = scheduler.now();
+        taskIds.push_back(scheduler.addTask([&, replayStart]() {
+            // Cap each burst so no subscriber queue overflows between reads
+            canReplayer->pump(scheduler.now() - replayStart, CANBus::QueueCapacity / 2);
+        }, 10, Scheduler::Priority::Normal));
+    }
+
+    // --- TASK 10: Shutdown Watch (100ms) ---
+    // Stops the scheduler once the owner asks (window closed, signal)
+    taskIds.push_back(scheduler.addTask([&]() {
+        if (!running) scheduler.stop();
+    }, 100, Scheduler::Priority::Low));
+
+    // Run until stopped, or for the configured span of scheduler time
+    if (config.duration > 0.0) {
+        scheduler.runFor(std::chrono::milliseconds(static_cast<int64_t>(config.duration * 1000.0)));
+    } else {
+        scheduler.run();
+    }
+
+    // All bands have joined: the statistics are safe to read
+    summary.simulatedSeconds = std::chrono::duration<double>(scheduler.now()).count();
+    if (summary.controlCycles > 0) {
+        summary.meanRPM = rpmSum / summary.controlCycles;
+        summary.meanInjectionMs = injectionSum / summary.controlCycles;
+    } else {
+        summary.minRPM = 0;
+    }
+    for (size_t id : taskIds) {
+        Scheduler::TaskStats stats = scheduler.getTaskStats(id);
+        summary.lateActivations += stats.late;
+        summary.missedDeadlines += stats.missed;
+    }
+
+    summary.activeFaults = activeFaults(dtc);
+    for (const auto& f : summary.activeFaults) {
+        bool before = std::any_of(faultsAtStart.begin(), faultsAtStart.end(),
+                                  [&](const DTC& old) { return old.code == f.code; });
+        if (!before) summary.newFaults.push_back(f);
+    }
+    return summary;
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include <atomic>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "../ECUState.h"
+#include "../dtc/DTC.h"
+
+// One step of a load profile: from `time` (seconds) on, the engine sees `load` Nm
+struct LoadStep {
+    double time;
+    float load;
+};
+
+// How to run the ECU task set. The dashboard fills it from the ECU_*
+// environment variables, the headless runner from a scenario file.
+struct EcuConfig {
+    uint64_t seed = 0x5EED;                 // Sensor noise
+    bool virtualClock = false;              // Scheduler::ClockMode::Virtual
+    double duration = 0.0;                  // Seconds of scheduler time; 0 = until stopped
+
+    std::string logFile = "ecu_log.csv";    // Empty = no telemetry log
+    bool binaryLog = false;
+    std::string flashImage = "ecu_flash.img";
+    std::string sensorReplay;               // .erc recording instead of simulated sensors
+
+    std::vector<LoadStep> loadProfile;      // Base load over time; empty = 0 Nm
+    bool tcu = true;                        // Simulated transmission sends torque requests
+    int tcuPeriodMs = 3000;
+    bool console = true;                    // Dashboard and fault printouts on stdout
+
+    std::string canInterface;               // SocketCAN mirror (e.g. vcan0)
+    std::string canRecord;                  // Trace file to record the bus to
+    std::string canReplay;                  // Trace file to inject
+    double canReplaySpeed = 1.0;
+
+    // ECU_SEED, ECU_CLOCK, ECU_LOG_FORMAT, ECU_REPLAY, ECU_CAN_IF,
+    // ECU_CAN_RECORD, ECU_CAN_REPLAY, ECU_CAN_REPLAY_SPEED (see README)
+    static EcuConfig fromEnvironment();
+};
+
+// What a run did, for the headless runner's report and exit status
+struct EcuSummary {
+    double simulatedSeconds = 0.0;
+    uint64_t controlCycles = 0;             // Logic task activations
+    int minRPM = 0;
+    int maxRPM = 0;
+    double meanRPM = 0.0;
+    float maxCoolant = 0.0f;
+    float maxInjectionMs = 0.0f;
+    double meanInjectionMs = 0.0;
+    double stallTime = -1.0;                // First time RPM fell below StallRPM, -1 if never
+    std::vector<DTC> newFaults;             // Active at the end but not at the start
+    std::vector<DTC> activeFaults;          // All active at the end (including restored ones)
+    uint64_t lateActivations = 0;
+    uint64_t missedDeadlines = 0;
+
+    static constexpr int StallRPM = 200;
+};
+
+// Builds the ECU task set (physics, control logic, diagnostics, CAN,
+// logging) on a scheduler and runs it on the calling thread until `running`
+// goes false or config.duration has passed. Every control cycle is published
+// to `state` for whoever displays it.
+EcuSummary runEcu(const EcuConfig& config, ECUState& state, const std::atomic<bool>& running);
@@ -0,0 +1,176 @@
+#include "Scenario.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+
+static std::string trim(const std::string& s) {
+    size_t begin = s.find_first_not_of(" \t\r");
+    if (begin == std::string::npos) return "";
+    size_t end = s.find_last_not_of(" \t\r");
+    return s.substr(begin, end - begin + 1);
+}
+
+static bool parseBool(const std::string& value, bool& out) {
+    if (value == "on" || value == "true" || value == "yes" || value == "1") out = true;
+    else if (value == "off" || value == "false" || value == "no" || value == "0") out = false;
+    else return false;
+    return true;
+}
+
+// Whole string must be a number
+static bool parseNumber(const std::string& value, double& out) {
+    if (value.empty()) return false;
+    char* end = nullptr;
+    out = std::strtod(value.c_str(), &end);
+    return *end == '\0';
+}
+
+// "0:0, 30:40, 90:80" -> steps sorted by time
+static bool parseLoadProfile(const std::string& value, std::vector<LoadStep>& out) {
+    out.clear();
+    size_t start = 0;
+    while (start < value.size()) {
+        size_t end = value.find(',', start);
+        if (end == std::string::npos) end = value.size();
+        std::string step = trim(value.substr(start, end - start));
+        start = end + 1;
+        if (step.empty()) continue;
+
+        size_t colon = step.find(':');
+        double time, load;
+        if (colon == std::string::npos || !parseNumber(trim(step.substr(0, colon)), time) ||
+            !parseNumber(trim(step.substr(colon + 1)), load) || time < 0.0) {
+            return false;
+        }
+        out.push_back({ time, static_cast<float>(load) });
+    }
+    std::stable_sort(out.begin(), out.end(), [](const LoadStep& a, const LoadStep& b) { return a.time < b.time; });
+    return !out.empty();
+}
+
+// One setting; false with `error` set for an unknown key or a bad value
+static bool applySetting(Scenario& scenario, const std::string& key, const std::string& value, std::string& error) {
+    EcuConfig& config = scenario.config;
+    double number = 0.0;
+    bool ok = true;
+
+    if (key == "duration") {
+        ok = parseNumber(value, number) && number > 0.0;
+        config.duration = number;
+    } else if (key == "clock") {
+        ok = value == "virtual" || value == "realtime";
+        config.virtualClock = value == "virtual";
+    } else if (key == "seed") {
+        // Whole string must be an unsigned integer that fits (strtoull
+        // accepts a sign and wraps negative values)
+        char* end = nullptr;
+        errno = 0;
+        config.seed = std::strtoull(value.c_str(), &end, 10);
+        ok = !value.empty() && value[0] >= '0' && value[0] <= '9' && *end == '\0' && errno != ERANGE;
+    } else if (key == "load") {
+        ok = parseLoadProfile(value, config.loadProfile);
+    } else if (key == "tcu") {
+        ok = parseBool(value, config.tcu);
+    } else if (key == "tcu_period") {
+        ok = parseNumber(value, number) && number >= 1.0;
+        config.tcuPeriodMs = static_cast<int>(number);
+    } else if (key == "log") {
+        config.logFile = value == "off" ? "" : value;
+    } else if (key == "log_format") {
+        ok = value == "csv" || value == "binary";
+        config.binaryLog = value == "binary";
+    } else if (key == "flash_image") {
+        config.flashImage = value;
+    } else if (key == "keep_flash") {
+        ok = parseBool(value, scenario.keepFlash);
+    } else if (key == "sensor_replay") {
+        config.sensorReplay = value;
+    } else if (key == "can_interface") {
+        config.canInterface = value;
+    } else if (key == "can_record") {
+        config.canRecord = value;
+    } else if (key == "can_replay") {
+        config.canReplay = value;
+    } else if (key == "can_replay_speed") {
+        ok = parseNumber(value, number) && number >= 0.0;
+        config.canReplaySpeed = number;
+    } else if (key == "console") {
+        ok = parseBool(value, config.console);
+    } else if (key == "summary") {
+        scenario.summaryFile = value;
+    } else if (key == "fail_on_dtc") {
+        ok = parseBool(value, scenario.failOnNewDTC);
+    } else if (key == "fail_on_stall") {
+        ok = parseBool(value, scenario.failOnStall);
+    } else {
+        error = "unknown setting '" + key + "'";
+        return false;
+    }
+
+    if (!ok) error = "bad value '" + value + "' for " + key;
+    return ok;
+}
+
+bool loadScenario(const std::string& path, const ScenarioOverrides& overrides, Scenario& scenario) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "[Scenario] Error: Could not open file " << path << "\n";
+        return false;
+    }
+
+    size_t slash = path.find_last_of("/\\");
+    std::string base = slash == std::string::npos ? path : path.substr(slash + 1);
+    scenario.name = base.substr(0, base.find_last_of('.'));
+    if (scenario.name.empty()) scenario.name = base;
+
+    scenario.config = EcuConfig();
+    scenario.config.virtualClock = true;
+    scenario.config.console = false;
+    scenario.config.seed = 1;
+    bool logSet = false, flashSet = false;
+
+    std::string line;
+    for (int lineNo = 1; std::getline(file, line); lineNo++) {
+        line = trim(line.substr(0, line.find('#')));
+        if (line.empty()) continue;
+
+        size_t eq = line.find('=');
+        std::string error;
+        if (eq == std::string::npos) {
+            error = "expected key = value";
+        } else {
+            std::string key = trim(line.substr(0, eq));
+            logSet |= key == "log";
+            flashSet |= key == "flash_image";
+            applySetting(scenario, key, trim(line.substr(eq + 1)), error);
+        }
+
+        if (!error.empty()) {
+            std::cerr << "[Scenario] Error: " << path << ":" << lineNo << ": " << error << "\n";
+            return false;
+        }
+    }
+
+    for (const auto& o : overrides) {
+        std::string error;
+        logSet |= o.first == "log";
+        flashSet |= o.first == "flash_image";
+        if (!applySetting(scenario, o.first, o.second, error)) {
+            std::cerr << "[Scenario] Error: " << o.first << "=" << o.second << ": " << error << "\n";
+            return false;
+        }
+    }
+
+    if (scenario.config.duration <= 0.0) {
+        std::cerr << "[Scenario] Error: " << path << " has no duration\n";
+        return false;
+    }
+
+    // Per-scenario, per-seed file names, so parallel instances stay apart
+    std::string prefix = scenario.name + "_" + std::to_string(scenario.config.seed);
+    if (!logSet) scenario.config.logFile = prefix + (scenario.config.binaryLog ? "_log.ecb" : "_log.csv");
+    if (!flashSet) scenario.config.flashImage = prefix + "_flash.img";
+    return true;
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include <string>
+#include <utility>
+#include <vector>
+#include "EcuTasks.h"
+
+// A headless run described in a small text file, one `key = value` per line
+// ('#' starts a comment):
+//
+//   duration      = 600                  # seconds of scheduler time (required)
+//   clock         = virtual              # virtual (default) | realtime
+//   seed          = 42                   # sensor noise (default 1)
+//   load          = 0:0, 30:40, 90:80    # time(s):load(Nm) steps
+//   tcu           = on                   # simulated transmission torque requests
+//   tcu_period    = 3000                 # ms between TCU commands
+//   log           = cruise_log.csv       # off = no telemetry log
+//   log_format    = csv                  # csv | binary
+//   flash_image   = cruise_flash.img
+//   keep_flash    = off                  # on = start from the last run's image
+//   sensor_replay = drive.erc            # recorded sensors (ecu_replay_convert)
+//   can_interface / can_record / can_replay / can_replay_speed
+//   console       = off                  # dashboard printouts on stdout (default off)
+//   summary       = cruise_summary.txt   # also write the summary as key = value
+//   fail_on_dtc   = on                   # a fault set during the run fails it
+//   fail_on_stall = on                   # RPM below EcuSummary::StallRPM fails it
+//
+// The log and flash image default to names made from the scenario file and
+// the seed ("cruise.scn", seed 7 -> "cruise_7_log.csv", "cruise_7_flash.img"),
+// so instances run side by side in one directory, e.g. one per seed, don't
+// share files. The image is deleted before each run unless keep_flash is on,
+// so faults stored by an earlier run don't carry over and a rerun with the
+// same settings repeats it exactly.
+struct Scenario {
+    std::string name;           // File name without directory and extension
+    EcuConfig config;
+    std::string summaryFile;    // Empty = stdout only
+    bool failOnNewDTC = true;
+    bool failOnStall = true;
+    bool keepFlash = false;     // Reuse the flash image left by the previous run
+};
+
+using ScenarioOverrides = std::vector<std::pair<std::string, std::string>>;
+
+// Parse a scenario file, then apply `overrides` (key/value pairs from the
+// command line, e.g. a per-instance seed) on top. Errors go to std::cerr with
+// the line number.
+bool loadScenario(const std::string& path, const ScenarioOverrides& overrides, Scenario& scenario);
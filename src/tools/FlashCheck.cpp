@@ -0,0 +1,101 @@
+// ecu_flash_check: remount a DTC journal left in a half-compacted state
+//
+//   ecu_flash_check [image]           (default: flash_check.img, overwritten)
+//
+// Builds the state a power loss can leave behind: the active sector already
+// partly full, and the sector after it (the spare position) still holding
+// live records because its compaction never finished. Then it remounts and
+// checks that every fault that was active before is still active, and that
+// the journal keeps working afterwards. Exit status 0 = pass, 1 = fail.
+
+#include "../memory/FlashMemory.h"
+#include "../memory/FlashLayout.h"
+#include "../dtc/DTC.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <set>
+#include <string>
+#include <vector>
+
+static const size_t JournalOffset = FlashLayout::entry(FlashLayout::Partition::DtcJournal).offset;
+static const size_t SectorSize = FlashMemory::SectorSize;
+
+static std::set<DTCCode> activeCodes(const std::string& image) {
+    FlashMemory flash(image);
+    std::set<DTCCode> codes;
+    for (const auto& f : flash.loadDTCs()) codes.insert(f.code);
+    return codes;
+}
+
+static bool moveSector(const std::string& image, size_t from, size_t to) {
+    std::fstream file(image, std::ios::in | std::ios::out | std::ios::binary);
+    if (!file.is_open()) return false;
+    std::vector<char> bytes(SectorSize), erased(SectorSize, static_cast<char>(0xFF));
+
+    file.seekg(JournalOffset + from * SectorSize);
+    file.read(bytes.data(), SectorSize);
+    file.seekp(JournalOffset + to * SectorSize);
+    file.write(bytes.data(), SectorSize);
+
+    // Leave `from` as an erased sector with a valid header, as erase() would
+    std::memcpy(erased.data(), bytes.data(), offsetof(FlashMemory::SectorHeader, generation));
+    file.seekp(JournalOffset + from * SectorSize);
+    file.write(erased.data(), SectorSize);
+    return static_cast<bool>(file);
+}
+
+int main(int argc, char** argv) {
+    std::string image = argc > 1 ? argv[1] : "flash_check.img";
+    std::remove(image.c_str());
+
+    const size_t full = FlashMemory::RecordsPerSector;   // Distinct faults filling sector 0
+    const size_t partial = 40;                           // Then set in sector 1
+    std::set<DTCCode> expected;
+    {
+        FlashMemory flash(image);
+        for (size_t i = 0; i < full + partial; i++) {
+            DTCCode code = static_cast<DTCCode>(0x0100 + i);
+            flash.commitDTC(code, true, "check " + std::to_string(i));
+            expected.insert(code);
+        }
+        flash.sync();
+    }
+    // Now: sector 0 full (oldest), sector 1 active with `partial` records,
+    // sector 2 the erased spare. Move sector 0's contents into the spare
+    // position: the spare still holds live records, as after a compaction
+    // cut short, while the active sector has only full - partial slots free.
+    if (!moveSector(image, 0, 2)) {
+        std::printf("FAIL: could not edit %s\n", image.c_str());
+        return 1;
+    }
+
+    std::set<DTCCode> afterRemount = activeCodes(image);
+
+    // The journal must still take new records, and keep them, after recovery
+    DTCCode extra = static_cast<DTCCode>(0x0100 + full + partial);
+    {
+        FlashMemory flash(image);
+        for (size_t i = 0; i < 2 * full; i++) flash.commitDTC(extra, i % 2 == 0, "toggle");
+        flash.commitDTC(extra, true, "extra");
+        flash.sync();
+    }
+    expected.insert(extra);
+    std::set<DTCCode> afterUse = activeCodes(image);
+
+    size_t lost = 0;
+    for (DTCCode code : expected) {
+        if (code != extra && !afterRemount.count(code)) lost++;
+        if (!afterUse.count(code)) lost++;
+    }
+    std::printf("%zu faults before, %zu after remount, %zu after further use\n",
+                expected.size() - 1, afterRemount.size(), afterUse.size());
+    std::remove(image.c_str());
+
+    if (lost > 0) {
+        std::printf("FAIL: %zu fault records lost\n", lost);
+        return 1;
+    }
+    std::printf("PASS\n");
+    return 0;
+}
@@ -0,0 +1,123 @@
+// ecu_fleet_check: EngineFleet against the scalar EnginePhysics it batches
+//
+//   ecu_fleet_check [--engines <n>] [--duration <s>] [--dt <s>] [--threads <n>]
+//                   [--tolerance <rpm>] [--seed <s>]
+//
+// Every engine gets its own friction, inertia and starting RPM, and a new
+// throttle and load every 0.5 s, all drawn from a seeded generator. The same
+// inputs go to one EngineFleet and to one EnginePhysics per engine. After each
+// 0.5 s block the two are compared; the run fails (exit 1) if any engine ever
+// differs by more than the tolerance. Both paths are timed over the same
+// blocks, so the table also gives what the fleet saves per engine step.
+
+#include "../engine/EngineFleet.h"
+#include "../engine/EnginePhysics.h"
+#include "../common/FastRandom.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+// Inputs are held for this long, as between two logic-rate changes in a sweep
+static const double BlockSeconds = 0.5;
+
+int main(int argc, char** argv) {
+    size_t engines = 10000;
+    double duration = 20.0;
+    float dt = 0.01f;
+    unsigned threads = 0;
+    double tolerance = 0.1;
+    uint64_t seed = 1;
+
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--engines") == 0 && i + 1 < argc) engines = std::strtoull(argv[++i], nullptr, 10);
+        else if (std::strcmp(argv[i], "--duration") == 0 && i + 1 < argc) duration = std::atof(argv[++i]);
+        else if (std::strcmp(argv[i], "--dt") == 0 && i + 1 < argc) dt = static_cast<float>(std::atof(argv[++i]));
+        else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) threads = static_cast<unsigned>(std::atoi(argv[++i]));
+        else if (std::strcmp(argv[i], "--tolerance") == 0 && i + 1 < argc) tolerance = std::atof(argv[++i]);
+        else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc) seed = std::strtoull(argv[++i], nullptr, 10);
+        else {
+            std::fprintf(stderr, "Usage: ecu_fleet_check [--engines <n>] [--duration <s>] [--dt <s>] [--threads <n>]\n"
+                                 "                       [--tolerance <rpm>] [--seed <s>]\n");
+            return 2;
+        }
+    }
+    if (engines == 0 || duration <= 0.0 || dt <= 0.0f) {
+        std::fprintf(stderr, "[ecu_fleet_check] Error: --engines, --duration and --dt must be positive\n");
+        return 2;
+    }
+
+    FastRandom rng(seed);
+    EngineFleet fleet(engines);
+    std::vector<EnginePhysics> scalar(engines);
+    for (size_t i = 0; i < engines; i++) {
+        float friction = rng.uniform(5.0f, 40.0f);
+        float inertia = rng.uniform(0.1f, 0.4f);
+        float startRPM = rng.uniform(600.0f, 6000.0f);
+
+        fleet.setFriction(i, friction);
+        fleet.setInertia(i, inertia);
+        fleet.setRPM(i, startRPM);
+        scalar[i].setFriction(friction);
+        scalar[i].setInertia(inertia);
+        scalar[i].setRPM(startRPM);
+    }
+
+    size_t stepsPerBlock = std::max<size_t>(1, static_cast<size_t>(std::lround(BlockSeconds / dt)));
+    size_t blocks = std::max<size_t>(1, static_cast<size_t>(std::lround(duration / BlockSeconds)));
+    std::vector<float> throttle(engines), load(engines);
+
+    double maxDiff = 0.0;
+    size_t worstEngine = 0;
+    std::chrono::duration<double> fleetTime{0}, scalarTime{0};
+
+    for (size_t b = 0; b < blocks; b++) {
+        // Now and then an engine is driven into the stall or redline clamp
+        for (size_t i = 0; i < engines; i++) {
+            throttle[i] = rng.uniform(0.0f, 100.0f);
+            load[i] = rng.uniform(0.0f, 120.0f);
+            fleet.setThrottle(i, throttle[i]);
+            fleet.setLoad(i, load[i]);
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        fleet.advance(stepsPerBlock, dt, threads);
+        auto mid = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < engines; i++) {
+            for (size_t s = 0; s < stepsPerBlock; s++) scalar[i].update(throttle[i], load[i], dt);
+        }
+        auto end = std::chrono::steady_clock::now();
+        fleetTime += mid - start;
+        scalarTime += end - mid;
+
+        for (size_t i = 0; i < engines; i++) {
+            double diff = std::fabs(static_cast<double>(fleet.getRPM(i)) - scalar[i].getRPM());
+            if (diff > maxDiff) {
+                maxDiff = diff;
+                worstEngine = i;
+            }
+        }
+    }
+
+    double engineSteps = static_cast<double>(engines) * blocks * stepsPerBlock;
+    double fleetNs = fleetTime.count() * 1e9 / engineSteps;
+    double scalarNs = scalarTime.count() * 1e9 / engineSteps;
+
+    std::printf("%zu engines x %zu steps of %g s, SIMD path %s\n\n", engines, blocks * stepsPerBlock, dt,
+                EngineFleet::getSimdPath());
+    std::printf("%-28s %14s %12s\n", "Path", "ns/engine-step", "Total(s)");
+    std::printf("%-28s %14.2f %12.3f\n", "EnginePhysics (1 thread)", scalarNs, scalarTime.count());
+    std::printf("%-28s %14.2f %12.3f\n", "EngineFleet", fleetNs, fleetTime.count());
+    std::printf("\nSpeed-up %.1fx. Max |dRPM| %g (engine %zu), tolerance %g\n",
+                fleetNs > 0.0 ? scalarNs / fleetNs : 0.0, maxDiff, worstEngine, tolerance);
+
+    if (maxDiff > tolerance) {
+        std::printf("FAIL\n");
+        return 1;
+    }
+    std::printf("PASS\n");
+    return 0;
+}
@@ -0,0 +1,108 @@
+// ecu_headless: run the ECU task set from a scenario file, without a window
+//
+//   ecu_headless <scenario.scn> [key=value ...]
+//
+// Runs the same tasks as the dashboard's ECU thread (src/sim/EcuTasks.cpp)
+// with no GUI thread or OpenGL context, prints a summary and exits with
+//   0  the run passed its checks
+//   1  it failed one (new DTC, stall) or was interrupted
+//   2  usage or scenario error
+// key=value arguments override the file, e.g. one instance per seed:
+//   for s in $(seq 1 32); do ecu_headless cruise.scn seed=$s & done; wait
+// See src/sim/Scenario.h for the settings.
+
+#include "../sim/Scenario.h"
+#include "../sim/EcuTasks.h"
+#include "../ECUState.h"
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <iostream>
+#include <string>
+
+static std::atomic<bool> running(true);
+
+static void onSignal(int) {
+    running = false;    // The task set's shutdown watch stops the scheduler
+}
+
+static void writeSummary(FILE* out, const Scenario& scenario, const EcuSummary& s, double wallSeconds,
+                         const std::string& result) {
+    std::fprintf(out, "scenario = %s\n", scenario.name.c_str());
+    std::fprintf(out, "seed = %llu\n", static_cast<unsigned long long>(scenario.config.seed));
+    std::fprintf(out, "simulated_s = %.3f\n", s.simulatedSeconds);
+    std::fprintf(out, "wall_s = %.3f\n", wallSeconds);
+    std::fprintf(out, "control_cycles = %llu\n", static_cast<unsigned long long>(s.controlCycles));
+    std::fprintf(out, "rpm_min = %d\n", s.minRPM);
+    std::fprintf(out, "rpm_mean = %.1f\n", s.meanRPM);
+    std::fprintf(out, "rpm_max = %d\n", s.maxRPM);
+    std::fprintf(out, "coolant_max_c = %.1f\n", s.maxCoolant);
+    std::fprintf(out, "injection_mean_ms = %.3f\n", s.meanInjectionMs);
+    std::fprintf(out, "injection_max_ms = %.3f\n", s.maxInjectionMs);
+    std::fprintf(out, "stall_s = %.2f\n", s.stallTime);
+
+    std::string newFaults, activeFaults;
+    for (const auto& f : s.newFaults) newFaults += (newFaults.empty() ? "" : " ") + dtcToString(f.code);
+    for (const auto& f : s.activeFaults) activeFaults += (activeFaults.empty() ? "" : " ") + dtcToString(f.code);
+    std::fprintf(out, "new_dtcs = %s\n", newFaults.empty() ? "none" : newFaults.c_str());
+    std::fprintf(out, "active_dtcs = %s\n", activeFaults.empty() ? "none" : activeFaults.c_str());
+
+    std::fprintf(out, "late_activations = %llu\n", static_cast<unsigned long long>(s.lateActivations));
+    std::fprintf(out, "missed_deadlines = %llu\n", static_cast<unsigned long long>(s.missedDeadlines));
+    std::fprintf(out, "result = %s\n", result.c_str());
+}
+
+int main(int argc, char** argv) {
+    std::string path;
+    ScenarioOverrides overrides;
+    bool usage = false;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        size_t eq = arg.find('=');
+        if (eq != std::string::npos) overrides.emplace_back(arg.substr(0, eq), arg.substr(eq + 1));
+        else if (path.empty()) path = arg;
+        else usage = true;
+    }
+
+    if (path.empty() || usage) {
+        std::cerr << "Usage: ecu_headless <scenario.scn> [key=value ...]\n";
+        return 2;
+    }
+
+    Scenario scenario;
+    if (!loadScenario(path, overrides, scenario)) return 2;
+
+    // A fresh image unless asked otherwise: faults stored by the last run
+    // would otherwise show up at startup and change this one
+    if (!scenario.keepFlash && std::remove(scenario.config.flashImage.c_str()) == 0) {
+        std::cerr << "[ecu_headless] Removed " << scenario.config.flashImage << " from the last run\n";
+    }
+
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+
+    ECUState state;
+    auto start = std::chrono::steady_clock::now();
+    EcuSummary summary = runEcu(scenario.config, state, running);
+    double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // Checks, in order of how much they say about the run
+    std::string result = "PASS";
+    if (!running) result = "FAIL (interrupted)";
+    else if (scenario.failOnStall && summary.stallTime >= 0.0) result = "FAIL (stalled)";
+    else if (scenario.failOnNewDTC && !summary.newFaults.empty()) result = "FAIL (new DTC)";
+
+    writeSummary(stdout, scenario, summary, wallSeconds, result);
+    if (!scenario.summaryFile.empty()) {
+        FILE* out = std::fopen(scenario.summaryFile.c_str(), "w");
+        if (out) {
+            writeSummary(out, scenario, summary, wallSeconds, result);
+            std::fclose(out);
+        } else {
+            std::cerr << "[ecu_headless] Error: Could not open file " << scenario.summaryFile << "\n";
+        }
+    }
+
+    return result == "PASS" ? 0 : 1;
+}
@@ -0,0 +1,126 @@
+// ecu_integrator_bench: accuracy versus cost of the EnginePhysics integrators
+//
+//   ecu_integrator_bench [--duration <s>] [--inertia <kg*m^2>]
+//
+// With constant throttle and load the model is linear in RPM,
+//   dRPM/dt = a - b * RPM,
+// so it has an exact solution to compare against:
+//   RPM(t) = a/b + (RPM0 - a/b) * exp(-b * t)
+// Each integrator advances the engine in 0.1 s calls (as a batch run would),
+// sub-stepped at the given step size (or tolerance, for RK45). The table gives
+// the worst error against the exact curve and the CPU time per simulated second.
+
+#include "../engine/EnginePhysics.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+struct Scenario {
+    const char* name;
+    float throttle;
+    float load;
+    float startRPM;
+};
+
+// All stay between stall and redline, where the exact solution holds
+static const Scenario Scenarios[] = {
+    { "tip-in 40%",      40.0f,  0.0f,  800.0f },
+    { "cruise 30%/40Nm", 30.0f, 40.0f, 3000.0f },
+    { "lift-off 10%",    10.0f,  5.0f, 6000.0f },
+};
+
+static const float CallInterval = 0.1f;
+
+struct Run {
+    double maxError = 0.0;
+    double nsPerSimSecond = 0.0;
+};
+
+static Run measure(EnginePhysics::Integrator method, float step, float tolerance, float inertia, double duration) {
+    Run run;
+    int calls = static_cast<int>(duration / CallInterval);
+
+    // Accuracy
+    for (const auto& sc : Scenarios) {
+        EnginePhysics engine;
+        engine.setInertia(inertia);
+        engine.setIntegrator(method);
+        engine.setTolerance(tolerance);
+        engine.setRPM(sc.startRPM);
+
+        double b = 0.02 / inertia * 9.549;
+        double a = (sc.throttle * 2.5 - 10.0 - sc.load) / inertia * 9.549;
+        double eq = a / b;
+
+        for (int i = 1; i <= calls; i++) {
+            engine.advance(sc.throttle, sc.load, CallInterval, step);
+            double exact = eq + (sc.startRPM - eq) * std::exp(-b * i * CallInterval);
+            run.maxError = std::max(run.maxError, std::fabs(engine.getRPM() - exact));
+        }
+    }
+
+    // Cost: repeat until the measurement is long enough to trust
+    size_t repeats = 0;
+    float sink = 0.0f;
+    auto start = std::chrono::steady_clock::now();
+    std::chrono::duration<double> elapsed{0};
+    do {
+        for (const auto& sc : Scenarios) {
+            EnginePhysics engine;
+            engine.setInertia(inertia);
+            engine.setIntegrator(method);
+            engine.setTolerance(tolerance);
+            engine.setRPM(sc.startRPM);
+            for (int i = 0; i < calls; i++) engine.advance(sc.throttle, sc.load, CallInterval, step);
+            sink += engine.getRPM();
+        }
+        repeats++;
+        elapsed = std::chrono::steady_clock::now() - start;
+    } while (elapsed.count() < 0.2);
+
+    double simSeconds = repeats * (sizeof(Scenarios) / sizeof(Scenarios[0])) * calls * CallInterval;
+    run.nsPerSimSecond = elapsed.count() * 1e9 / simSeconds;
+    if (sink < 0.0f) std::printf(" "); // Keep the work from being optimized away
+    return run;
+}
+
+int main(int argc, char** argv) {
+    double duration = 10.0;
+    float inertia = 0.2f;
+
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--duration") == 0 && i + 1 < argc) duration = std::atof(argv[++i]);
+        else if (std::strcmp(argv[i], "--inertia") == 0 && i + 1 < argc) inertia = static_cast<float>(std::atof(argv[++i]));
+        else {
+            std::fprintf(stderr, "Usage: ecu_integrator_bench [--duration <s>] [--inertia <kg*m^2>]\n");
+            return 2;
+        }
+    }
+
+    using I = EnginePhysics::Integrator;
+    std::printf("Inertia %g kg*m^2, %g s per scenario, reference = exact solution\n\n", inertia, duration);
+    std::printf("%-20s %10s %16s %18s\n", "Integrator", "Step(s)", "MaxError(RPM)", "ns per sim second");
+
+    const float steps[] = { 0.001f, 0.01f, 0.05f, 0.1f };
+    const struct { I method; const char* name; } fixed[] = {
+        { I::Euler, "Euler" },
+        { I::SemiImplicitEuler, "Semi-implicit Euler" },
+        { I::RK4, "RK4" },
+    };
+    for (const auto& m : fixed) {
+        for (float h : steps) {
+            Run r = measure(m.method, h, 0.0f, inertia, duration);
+            std::printf("%-20s %10g %16.4g %18.0f\n", m.name, h, r.maxError, r.nsPerSimSecond);
+        }
+    }
+
+    std::printf("\n%-20s %10s %16s %18s\n", "Integrator", "Tol(RPM)", "MaxError(RPM)", "ns per sim second");
+    for (float tol : { 1.0f, 0.1f, 0.01f }) {
+        Run r = measure(I::RK45, 0.0f, tol, inertia, duration);
+        std::printf("%-20s %10g %16.4g %18.0f\n", "RK45 (adaptive)", tol, r.maxError, r.nsPerSimSecond);
+    }
+    return 0;
+}
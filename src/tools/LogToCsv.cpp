@@ -0,0 +1,73 @@
+// ecu_log2csv: convert a binary ECU log (.ecb) back to the ecu_log.csv schema
+//
+//   ecu_log2csv <input.ecb> [output.csv] [--from <seconds>] [--to <seconds>]
+//
+// --from uses the chunk index to seek, so exporting minute 47 of a long run
+// doesn't decode the 46 minutes before it.
+//
+// The binary log stores throttle, coolant, load and injection time rounded to
+// 1/BinaryLog::ValueScale (0.001), so the export is lossy next to a CSV
+// written directly by the logger.
+
+#include "../logging/BinaryLog.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <iostream>
+#include <string>
+#include <vector>
+
+int main(int argc, char** argv) {
+    std::string input, output;
+    double fromSec = -std::numeric_limits<double>::infinity();
+    double toSec = std::numeric_limits<double>::infinity();
+
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--from") == 0 && i + 1 < argc) fromSec = std::atof(argv[++i]);
+        else if (std::strcmp(argv[i], "--to") == 0 && i + 1 < argc) toSec = std::atof(argv[++i]);
+        else if (input.empty()) input = argv[i];
+        else if (output.empty()) output = argv[i];
+    }
+
+    if (input.empty()) {
+        std::cerr << "Usage: ecu_log2csv <input.ecb> [output.csv] [--from <s>] [--to <s>]\n"
+                     "Throttle, coolant, load and injection come out rounded to "
+                  << 1.0 / BinaryLog::ValueScale << " (the binary log's resolution).\n";
+        return 2;
+    }
+
+    BinaryLogReader reader;
+    if (!reader.open(input)) return 1;
+
+    FILE* out = output.empty() ? stdout : std::fopen(output.c_str(), "w");
+    if (!out) {
+        std::cerr << "[ecu_log2csv] Error: Could not open file " << output << "\n";
+        return 1;
+    }
+
+    std::fprintf(out, "Time(s),RPM,Throttle(%%),Coolant(C),Load(Nm),Injection(ms),DTC\n");
+
+    std::vector<LogRecord> rows;
+    rows.reserve(BinaryLog::ChunkRows);
+    size_t written = 0;
+
+    for (size_t c = reader.findChunk(fromSec); c < reader.getChunkCount(); c++) {
+        if (reader.getChunk(c).firstTimeUs / BinaryLog::TimeScale > toSec) break;
+        if (!reader.readChunk(c, rows)) {
+            std::cerr << "[ecu_log2csv] Warning: Chunk " << c << " is corrupt, stopping\n";
+            break;
+        }
+
+        for (const auto& r : rows) {
+            if (r.timestamp < fromSec || r.timestamp > toSec) continue;
+            std::fprintf(out, "%g,%d,%g,%g,%g,%g,%s\n", r.timestamp, r.rpm, r.throttle,
+                         r.coolant, r.load, r.fuel, r.activeDTC);
+            written++;
+        }
+    }
+
+    if (out != stdout) std::fclose(out);
+    std::cerr << "[ecu_log2csv] Wrote " << written << " rows\n";
+    return 0;
+}
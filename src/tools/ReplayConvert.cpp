@@ -0,0 +1,152 @@
+// ecu_replay_convert: turn a CSV vehicle recording into a sensor replay file (.erc)
+//
+//   ecu_replay_convert <input.csv> <output.erc>
+//
+// The first line names the columns. Time(s) is required; Throttle, Coolant,
+// IntakeTemp and Load are picked up by name (units in brackets and case are
+// ignored) and any that are missing are filled with a constant. ecu_log.csv
+// converts as-is, so a simulator run can be replayed too. The input is
+// streamed, so recordings larger than RAM convert fine.
+
+#include "../sensors/SensorReplay.h"
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace SensorRecording;
+
+// "Throttle(%)" -> "throttle"
+static std::string columnKey(const std::string& name) {
+    std::string key;
+    for (char c : name) {
+        if (c == '(' || c == '[') break;
+        if (!std::isspace(static_cast<unsigned char>(c))) key += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+    return key;
+}
+
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        std::cerr << "Usage: ecu_replay_convert <input.csv> <output.erc>\n";
+        return 2;
+    }
+
+    std::ifstream in(argv[1]);
+    if (!in.is_open()) {
+        std::cerr << "[ecu_replay_convert] Error: Could not open file " << argv[1] << "\n";
+        return 1;
+    }
+
+    // Column of each channel in the CSV, -1 if absent
+    std::string line;
+    std::getline(in, line);
+    int timeColumn = -1;
+    int columns[ChannelCount] = { -1, -1, -1, -1 };
+    const char* names[ChannelCount] = { "throttle", "coolant", "intaketemp", "load" };
+    const float defaults[ChannelCount] = { 0.0f, 90.0f, 30.0f, 0.0f };
+
+    int column = 0;
+    for (size_t start = 0; start <= line.size(); column++) {
+        size_t end = line.find(',', start);
+        if (end == std::string::npos) end = line.size();
+        std::string key = columnKey(line.substr(start, end - start));
+        if (key == "time") timeColumn = column;
+        for (uint32_t ch = 0; ch < ChannelCount; ch++) {
+            if (key == names[ch]) columns[ch] = column;
+        }
+        start = end + 1;
+    }
+
+    if (timeColumn < 0) {
+        std::cerr << "[ecu_replay_convert] Error: No Time column in " << argv[1] << "\n";
+        return 1;
+    }
+    for (uint32_t ch = 0; ch < ChannelCount; ch++) {
+        if (columns[ch] < 0) {
+            std::cerr << "[ecu_replay_convert] Warning: No " << names[ch] << " column, using " << defaults[ch] << "\n";
+        }
+    }
+
+    FILE* out = std::fopen(argv[2], "wb");
+    if (!out) {
+        std::cerr << "[ecu_replay_convert] Error: Could not open file " << argv[2] << "\n";
+        return 1;
+    }
+
+    // Header is written again with the final counts at the end
+    FileHeader header{};
+    std::memcpy(header.magic, Magic, sizeof(Magic));
+    header.version = Version;
+    header.channelCount = ChannelCount;
+    std::fwrite(&header, sizeof(header), 1, out);
+
+    std::vector<Frame> batch;
+    batch.reserve(4096);
+    std::vector<double> fields;
+    uint64_t frames = 0, skipped = 0;
+    double lastTime = 0.0;
+
+    auto flush = [&]() {
+        std::fwrite(batch.data(), sizeof(Frame), batch.size(), out);
+        batch.clear();
+    };
+
+    while (std::getline(in, line)) {
+        if (line.empty()) continue;
+
+        fields.clear();
+        const char* p = line.c_str();
+        while (true) {
+            fields.push_back(std::strtod(p, nullptr));
+            p = std::strchr(p, ',');
+            if (!p) break;
+            p++;
+        }
+
+        if (timeColumn >= static_cast<int>(fields.size())) {
+            skipped++;
+            continue;
+        }
+
+        // Playback interpolates between neighbours, so time must strictly increase
+        double time = fields[timeColumn];
+        if (frames > 0 && time <= lastTime) {
+            skipped++;
+            continue;
+        }
+
+        Frame f;
+        f.time = time;
+        for (uint32_t ch = 0; ch < ChannelCount; ch++) {
+            int c = columns[ch];
+            f.values[ch] = (c >= 0 && c < static_cast<int>(fields.size())) ? static_cast<float>(fields[c]) : defaults[ch];
+        }
+        batch.push_back(f);
+        if (batch.size() == batch.capacity()) flush();
+
+        if (frames == 0) header.startTime = time;
+        lastTime = time;
+        frames++;
+    }
+    flush();
+
+    header.frameCount = frames;
+    header.endTime = lastTime;
+    std::fseek(out, 0, SEEK_SET);
+    std::fwrite(&header, sizeof(header), 1, out);
+    bool ok = std::ferror(out) == 0;
+    std::fclose(out);
+
+    if (!ok) {
+        std::cerr << "[ecu_replay_convert] Error: Write to " << argv[2] << " failed\n";
+        return 1;
+    }
+    std::cerr << "[ecu_replay_convert] Wrote " << frames << " frames (" << (lastTime - header.startTime)
+              << " s), skipped " << skipped << " rows\n";
+    return frames > 0 ? 0 : 1;
+}
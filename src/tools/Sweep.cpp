@@ -0,0 +1,408 @@
+// ecu_sweep: headless parameter sweep / Monte Carlo over the engine and fuel model
+//
+//   ecu_sweep [name=spec ...] [--samples <n>] [--seed <s>] [--duration <s>]
+//             [--dt <s>] [--threads <n>] [--driver cycle|sensors] [--out <summary.csv>]
+//
+// Parameters (default in brackets):
+//   friction   internal friction torque, Nm      [10]
+//   inertia    flywheel + crank inertia, kg*m^2  [0.2]
+//   ve         scale applied to the ECU's VE map [1.0]
+//
+// Specs:
+//   value      fixed
+//   lo:hi:n    grid of n values from lo to hi (with --samples: uniform lo..hi)
+//   lo:hi      uniform lo..hi                  (needs --samples)
+//   mean~sd    normal distribution             (needs --samples), truncated
+//              to positive values: a draw <= 0 is drawn again
+//
+// All three parameters must be positive (zero inertia divides by zero, a
+// negative one runs the engine backwards), so values, ranges and means <= 0
+// are rejected.
+//
+// Without --samples every grid combination is run; with it, --samples
+// instances each draw their parameters at random (seeded, so a run is
+// repeatable). Each instance drives the engine through a fixed throttle/load
+// cycle (--driver cycle, default) or with the throttle read from its own
+// SensorModule, seeded per instance (--driver sensors), and reports time to
+// stall, AFR error and injection statistics, one row per instance in the
+// summary CSV. The ECU side always reads RPM through the sensors, as in the
+// ECU task.
+//
+// Instances run in batches of InstancesPerJob, one batch per pool job: the
+// engines of a batch are one EngineFleet stepped together at the physics rate,
+// while each instance keeps its own SensorModule and FuelControl, run at the
+// 50 ms logic rate.
+//
+// AFR error: the ECU sizes each pulse for the air its map predicts at the
+// sensed RPM and pedal position, and the pulse is held until the next logic
+// cycle. At every physics step the cylinder actually fills by a reference
+// engine (the default VE map) at the true RPM and the throttle applied
+// (anti-stall included). Sensor noise and lag, the 50 ms hold during
+// transients, and the operating points that friction and inertia lead to all
+// show up, on top of any error in the calibration itself (ve).
+
+#include "../engine/EngineFleet.h"
+#include "../engine/FuelControl.h"
+#include "../sensors/SensorModule.h"
+#include "../common/WorkStealingPool.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// Below this the engine counts as stalled and the run ends
+static const float StallRPM = 200.0f;
+
+// Instances per pool job, stepped as one EngineFleet: enough for whole SIMD
+// vectors and to amortize the job, small enough to balance across threads
+static const size_t InstancesPerJob = 64;
+
+struct ParamSpec {
+    enum class Kind { Fixed, Grid, Uniform, Normal };
+
+    std::string name;
+    Kind kind = Kind::Fixed;
+    double a = 0.0, b = 0.0;   // Fixed: a. Grid/Uniform: lo, hi. Normal: mean, sd.
+    int count = 1;              // Grid points
+};
+
+struct Config {
+    float friction = 10.0f;
+    float inertia = 0.2f;
+    float veScale = 1.0f;
+    uint64_t sensorSeed = 0;
+};
+
+struct Result {
+    double timeToStall = -1.0;  // Seconds, -1 if it never stalled
+    double afrErrorMean = 0.0;  // Mean |delivered AFR - target AFR| over fuelled physics steps
+    double injMean = 0.0;
+    double injMax = 0.0;
+    double injStd = 0.0;
+    float finalRPM = 0.0f;
+};
+
+// --- Drive cycle (20 s, repeated) ---
+
+struct CyclePoint {
+    float throttle;
+    float load;
+};
+
+static CyclePoint driveCycle(double t) {
+    double c = std::fmod(t, 20.0);
+    if (c < 4.0)  return { 0.0f, 0.0f };                                 // Idle
+    if (c < 8.0)  return { static_cast<float>((c - 4.0) / 4.0 * 50.0), 0.0f };   // Tip-in to 50%
+    if (c < 12.0) return { 100.0f, 30.0f };                              // Full throttle, power enrichment
+    if (c < 16.0) return { 0.0f, 0.0f };                                 // Overrun, fuel cut
+    return { 30.0f, 40.0f };                                              // Cruise under load
+}
+
+// One instance's ECU side: its own sensors and calibration, run at the logic rate
+struct Instance {
+    SensorModule sensors;
+    FuelControl ecu;
+    float pedal = 0.0f;         // What the throttle sensor (or the cycle) says
+    bool stalled = false;
+
+    // Fuel scheduled by the last logic cycle, held until the next one
+    bool fuelling = false;
+    float veBelieved = 1.0f;    // VE the ECU assumed for it
+    float targetAFR = 14.7f;
+    size_t veXHint = 0, veYHint = 0;
+
+    double afrErrorSum = 0.0;
+    size_t afrSamples = 0;
+    double injSum = 0.0, injSqSum = 0.0;
+    size_t injCount = 0;
+
+    explicit Instance(uint64_t seed) : sensors(seed) {}
+};
+
+// Runs `count` instances side by side: the physics of all of them as one
+// EngineFleet step, then each instance's sensors and fuel logic. Instances
+// don't interact, so a result doesn't depend on which batch it ran in.
+static void simulateBatch(const Config* cfgs, Result* results, size_t count, double duration, float dt,
+                          bool sensorDriver) {
+    EngineFleet fleet(count);
+    std::vector<Instance> inst;
+    inst.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        fleet.setFriction(i, cfgs[i].friction);
+        fleet.setInertia(i, cfgs[i].inertia);
+
+        inst.emplace_back(cfgs[i].sensorSeed);
+        auto& ve = inst[i].ecu.getVEMap();
+        for (size_t iy = 0; iy < ve.getYAxis().size(); iy++) {
+            for (size_t ix = 0; ix < ve.getXAxis().size(); ix++) ve.at(ix, iy) *= cfgs[i].veScale;
+        }
+    }
+
+    // How the engine actually breathes, shared by the batch
+    FuelControl reference;
+    const FuelControl::VEMap& trueVE = reference.getVEMap();
+
+    // Fuel is computed at the logic rate (50 ms), like the ECU task
+    size_t logicEvery = std::max<size_t>(1, static_cast<size_t>(std::lround(0.05 / dt)));
+    size_t steps = static_cast<size_t>(duration / dt);
+    size_t running = count;
+    float* throttle = fleet.throttleData();
+    float* load = fleet.loadData();
+
+    for (size_t k = 0; k < steps && running > 0; k++) {
+        double t = k * static_cast<double>(dt);
+        CyclePoint p = driveCycle(t);
+
+        for (size_t i = 0; i < count; i++) {
+            Instance& in = inst[i];
+            if (in.stalled) continue;
+            in.pedal = sensorDriver ? in.sensors.getThrottle() : p.throttle;
+            // Anti-stall, as in the ECU task: the engine gets it, the sensor doesn't see it
+            throttle[i] = (in.pedal < 1.0f && fleet.getRPM(i) < 650) ? 6.0f : in.pedal;
+            load[i] = p.load;
+        }
+
+        fleet.step(dt);
+
+        bool logicCycle = k % logicEvery == 0;
+        for (size_t i = 0; i < count; i++) {
+            Instance& in = inst[i];
+            if (in.stalled) continue;
+            float engineRPM = fleet.getRPM(i);
+            in.sensors.setSimulatedRPM(static_cast<int>(engineRPM));
+
+            if (engineRPM < StallRPM) {
+                in.stalled = true;       // The fleet keeps stepping it; its result is final
+                results[i].timeToStall = t + dt;
+                results[i].finalRPM = engineRPM;
+                running--;
+                continue;
+            }
+
+            if (logicCycle) {
+                int rpm = in.sensors.getRPM();
+                float inj = in.ecu.calculateInjectionTime(rpm, in.pedal, 30.0f);
+                in.injSum += inj;
+                in.injSqSum += static_cast<double>(inj) * inj;
+                in.injCount++;
+                results[i].injMax = std::max(results[i].injMax, static_cast<double>(inj));
+
+                in.fuelling = inj > 0.0f;
+                in.veBelieved = in.ecu.getVEMap().lookup(static_cast<float>(rpm), in.pedal);
+                in.targetAFR = in.ecu.getAFR();
+            }
+
+            if (in.fuelling) {
+                // Fuel was sized for the air the ECU believed in (noisy, lagged
+                // RPM sensor, pedal position, scaled map, 50 ms old); the
+                // cylinder fills by the reference VE at the true speed and the
+                // throttle actually applied
+                float veTrue = trueVE.lookup(engineRPM, throttle[i], in.veXHint, in.veYHint);
+                double delivered = in.targetAFR * (veTrue / in.veBelieved);
+                in.afrErrorSum += std::fabs(delivered - in.targetAFR);
+                in.afrSamples++;
+            }
+        }
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        const Instance& in = inst[i];
+        Result& r = results[i];
+        if (!in.stalled) r.finalRPM = fleet.getRPM(i);
+        if (in.afrSamples > 0) r.afrErrorMean = in.afrErrorSum / in.afrSamples;
+        if (in.injCount > 0) {
+            r.injMean = in.injSum / in.injCount;
+            r.injStd = std::sqrt(std::max(0.0, in.injSqSum / in.injCount - r.injMean * r.injMean));
+        }
+    }
+}
+
+// --- Command line ---
+
+static bool parseSpec(const std::string& arg, ParamSpec& spec) {
+    size_t eq = arg.find('=');
+    if (eq == std::string::npos) return false;
+    spec.name = arg.substr(0, eq);
+    std::string value = arg.substr(eq + 1);
+
+    if (spec.name != "friction" && spec.name != "inertia" && spec.name != "ve") {
+        std::cerr << "[ecu_sweep] Error: unknown parameter '" << spec.name << "'\n";
+        return false;
+    }
+
+    if (value.find('~') != std::string::npos) {
+        spec.kind = ParamSpec::Kind::Normal;
+        if (std::sscanf(value.c_str(), "%lf~%lf", &spec.a, &spec.b) != 2 || spec.b < 0.0) return false;
+    } else {
+        int fields = std::sscanf(value.c_str(), "%lf:%lf:%d", &spec.a, &spec.b, &spec.count);
+        if (fields == 3 && spec.count >= 1) spec.kind = ParamSpec::Kind::Grid;
+        else if (fields == 2) spec.kind = ParamSpec::Kind::Uniform;
+        else if (fields == 1) spec.kind = ParamSpec::Kind::Fixed;
+        else return false;
+    }
+
+    // Mean (normal) or every end of the range must be positive
+    bool range = spec.kind == ParamSpec::Kind::Grid || spec.kind == ParamSpec::Kind::Uniform;
+    if (spec.a <= 0.0 || (range && spec.b <= 0.0)) {
+        std::cerr << "[ecu_sweep] Error: '" << spec.name << "' must be positive\n";
+        return false;
+    }
+    return true;
+}
+
+// Normal draw truncated to positive values. The mean is positive, so each
+// try succeeds at least half the time; the cap only guards against NaN.
+static double positiveNormal(std::mt19937_64& rng, double mean, double sd) {
+    std::normal_distribution<double> normal(mean, sd);
+    for (int attempt = 0; attempt < 64; attempt++) {
+        double v = normal(rng);
+        if (v > 0.0) return v;
+    }
+    return mean;
+}
+
+static void setParam(Config& cfg, const std::string& name, double value) {
+    if (name == "friction") cfg.friction = static_cast<float>(value);
+    else if (name == "inertia") cfg.inertia = static_cast<float>(value);
+    else if (name == "ve") cfg.veScale = static_cast<float>(value);
+}
+
+// Every combination of the grid values
+static std::vector<Config> buildGrid(const std::vector<ParamSpec>& specs) {
+    std::vector<Config> configs(1);
+    for (const auto& s : specs) {
+        std::vector<Config> next;
+        int n = (s.kind == ParamSpec::Kind::Grid) ? s.count : 1;
+        for (const auto& base : configs) {
+            for (int i = 0; i < n; i++) {
+                double v = (n == 1) ? s.a : s.a + (s.b - s.a) * i / (n - 1);
+                Config c = base;
+                setParam(c, s.name, v);
+                next.push_back(c);
+            }
+        }
+        configs.swap(next);
+    }
+    return configs;
+}
+
+// Instance i draws from its own generator, so results don't depend on which
+// worker ran it
+static std::vector<Config> buildSamples(const std::vector<ParamSpec>& specs, size_t samples, uint64_t seed) {
+    std::vector<Config> configs(samples);
+    for (size_t i = 0; i < samples; i++) {
+        std::mt19937_64 rng(seed + i * 0x9E3779B97F4A7C15ull);
+        for (const auto& s : specs) {
+            double v = s.a;
+            if (s.kind == ParamSpec::Kind::Grid || s.kind == ParamSpec::Kind::Uniform) {
+                v = std::uniform_real_distribution<double>(s.a, s.b)(rng);
+            } else if (s.kind == ParamSpec::Kind::Normal) {
+                v = positiveNormal(rng, s.a, s.b);
+            }
+            setParam(configs[i], s.name, v);
+        }
+    }
+    return configs;
+}
+
+int main(int argc, char** argv) {
+    std::vector<ParamSpec> specs;
+    std::string output = "sweep_summary.csv";
+    size_t samples = 0;
+    uint64_t seed = 1;
+    double duration = 60.0;
+    float dt = 0.01f;
+    unsigned threads = 0;
+    bool sensorDriver = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--samples") == 0 && i + 1 < argc) samples = std::strtoull(argv[++i], nullptr, 10);
+        else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc) seed = std::strtoull(argv[++i], nullptr, 10);
+        else if (std::strcmp(argv[i], "--duration") == 0 && i + 1 < argc) duration = std::atof(argv[++i]);
+        else if (std::strcmp(argv[i], "--dt") == 0 && i + 1 < argc) dt = static_cast<float>(std::atof(argv[++i]));
+        else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) threads = static_cast<unsigned>(std::atoi(argv[++i]));
+        else if (std::strcmp(argv[i], "--out") == 0 && i + 1 < argc) output = argv[++i];
+        else if (std::strcmp(argv[i], "--driver") == 0 && i + 1 < argc) sensorDriver = std::strcmp(argv[++i], "sensors") == 0;
+        else {
+            ParamSpec spec;
+            if (!parseSpec(argv[i], spec)) {
+                std::cerr << "Usage: ecu_sweep [friction|inertia|ve=<value|lo:hi:n|lo:hi|mean~sd> ...]\n"
+                             "                 [--samples <n>] [--seed <s>] [--duration <s>] [--dt <s>]\n"
+                             "                 [--threads <n>] [--driver cycle|sensors] [--out <summary.csv>]\n";
+                return 2;
+            }
+            specs.push_back(spec);
+        }
+    }
+
+    if (dt <= 0.0f || duration <= 0.0) {
+        std::cerr << "[ecu_sweep] Error: --dt and --duration must be positive\n";
+        return 2;
+    }
+    if (samples == 0) {
+        for (const auto& s : specs) {
+            if (s.kind == ParamSpec::Kind::Uniform || s.kind == ParamSpec::Kind::Normal) {
+                std::cerr << "[ecu_sweep] Error: '" << s.name << "' is a distribution; add --samples\n";
+                return 2;
+            }
+        }
+    }
+
+    std::vector<Config> configs = samples > 0 ? buildSamples(specs, samples, seed) : buildGrid(specs);
+
+    // Every instance gets its own sensor noise stream, fixed by --seed and its index
+    for (size_t i = 0; i < configs.size(); i++) {
+        configs[i].sensorSeed = seed * 0x100000001B3ull + i;
+    }
+    std::vector<Result> results(configs.size());
+
+    auto start = std::chrono::steady_clock::now();
+    {
+        WorkStealingPool pool(threads);
+        std::cerr << "[ecu_sweep] " << configs.size() << " instances x " << duration << " s on "
+                  << pool.size() << " threads\n";
+
+        for (size_t begin = 0; begin < configs.size(); begin += InstancesPerJob) {
+            size_t end = std::min(configs.size(), begin + InstancesPerJob);
+            pool.submit([&, begin, end]() {
+                simulateBatch(&configs[begin], &results[begin], end - begin, duration, dt, sensorDriver);
+            });
+        }
+        pool.wait();
+    }
+    double wallSec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    FILE* out = std::fopen(output.c_str(), "w");
+    if (!out) {
+        std::cerr << "[ecu_sweep] Error: Could not open file " << output << "\n";
+        return 1;
+    }
+    std::fprintf(out, "Instance,Friction(Nm),Inertia(kgm2),VEScale,TimeToStall(s),AFRError,InjMean(ms),InjMax(ms),InjStd(ms),FinalRPM\n");
+    size_t stalled = 0;
+    size_t best = configs.size();   // Among instances that ran the whole cycle
+    for (size_t i = 0; i < configs.size(); i++) {
+        const Config& c = configs[i];
+        const Result& r = results[i];
+        std::fprintf(out, "%zu,%g,%g,%g,%g,%g,%g,%g,%g,%g\n", i, c.friction, c.inertia, c.veScale,
+                     r.timeToStall, r.afrErrorMean, r.injMean, r.injMax, r.injStd, r.finalRPM);
+        if (r.timeToStall >= 0.0) stalled++;
+        else if (best == configs.size() || r.afrErrorMean < results[best].afrErrorMean) best = i;
+    }
+    std::fclose(out);
+
+    std::cerr << "[ecu_sweep] Done in " << wallSec << " s (" << configs.size() * duration / wallSec
+              << "x real time). Stalled: " << stalled << "/" << configs.size() << "\n";
+    if (best < configs.size()) {
+        std::cerr << "[ecu_sweep] Lowest AFR error (not stalled) " << results[best].afrErrorMean << " at friction="
+                  << configs[best].friction << " inertia=" << configs[best].inertia
+                  << " ve=" << configs[best].veScale << "\n";
+    }
+    std::cerr << "[ecu_sweep] Summary written to " << output << "\n";
+    return 0;
+}